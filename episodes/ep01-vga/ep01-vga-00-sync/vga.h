@@ -1,19 +1,19 @@
-/*
- * Project: pico-56 - episode 1
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-#ifndef _PICO56_VGA_H
-#define _PICO56_VGA_H
-
-#include <inttypes.h>
-
-void vgaInit();
-
+/*
+ * Project: pico-56 - episode 1
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#ifndef _PICO56_VGA_H
+#define _PICO56_VGA_H
+
+#include <inttypes.h>
+
+void vgaInit();
+
 #endif
\ No newline at end of file
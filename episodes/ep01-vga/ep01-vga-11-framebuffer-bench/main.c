@@ -0,0 +1,183 @@
+/*
+ * Project: pico-56 - episode 1
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "vga.h"
+#include "vga-modes.h"
+#include "vga-framebuffer.h"
+
+#include "pico/stdlib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+ /*
+  * framebuffer benchmark. each test draws for a second while the display is
+  * running, then prints its fill rate over usb serial. the first test is the
+  * nibble-at-a-time fill from ep01-vga-08-framebuffer-800 for comparison
+  */
+
+#define FB_WIDTH    400
+#define FB_HEIGHT   300
+#define TEST_US     1000000
+
+uint8_t __aligned(4) frameBuffer[FB_WIDTH / 2 * FB_HEIGHT];
+uint8_t __aligned(4) blitImage[64 / 2 * 64];
+VgaFramebuffer fb;
+
+static const uint16_t palette[FB_COLOURS] = {
+  0x000, 0x777, 0xf00, 0xff0, 0x0f0, 0x0ff, 0x00f, 0xf0f,
+  0x800, 0x880, 0x080, 0x088, 0x008, 0x808, 0xaaa, 0xfff
+};
+
+void frameBufferScanline(uint16_t y, VgaParams* params, uint16_t* pixels)
+{
+  fbScanline(&fb, y, pixels);
+}
+
+/*
+ * the original byte/nibble filled rectangle
+ */
+void referenceFilledRect(int x, int y, int w, int h, uint8_t c)
+{
+  for (int row = y; row < y + h; ++row)
+  {
+    uint8_t* p = frameBuffer + row * fb.stride;
+    for (int col = x; col < x + w; ++col)
+    {
+      if (col & 1)
+      {
+        p[col / 2] = (p[col / 2] & 0xf0) | c;
+      }
+      else
+      {
+        p[col / 2] = (p[col / 2] & 0x0f) | (c << 4);
+      }
+    }
+  }
+}
+
+typedef enum
+{
+  TEST_REFERENCE_RECT,
+  TEST_FILLED_RECT,
+  TEST_CLEAR,
+  TEST_LINE,
+  TEST_FILLED_CIRCLE,
+  TEST_BLIT,
+  TEST_COUNT
+} BenchTest;
+
+static const char* testNames[TEST_COUNT] = {
+  "reference rect",
+  "filled rect",
+  "clear",
+  "line",
+  "filled circle",
+  "blit 64x64"
+};
+
+/*
+ * draw one random shape. returns the number of pixels drawn
+ */
+uint32_t drawOne(BenchTest test)
+{
+  int x = rand() % FB_WIDTH;
+  int y = rand() % FB_HEIGHT;
+  int w = 1 + rand() % (FB_WIDTH - x);
+  int h = 1 + rand() % (FB_HEIGHT - y);
+  uint8_t c = rand() & 0x0f;
+
+  switch (test)
+  {
+    case TEST_REFERENCE_RECT:
+      referenceFilledRect(x, y, w, h, c);
+      return w * h;
+
+    case TEST_FILLED_RECT:
+      fbFilledRect(&fb, x, y, w, h, c);
+      return w * h;
+
+    case TEST_CLEAR:
+      fbClear(&fb, c);
+      return FB_WIDTH * FB_HEIGHT;
+
+    case TEST_LINE:
+    {
+      int x1 = rand() % FB_WIDTH, y1 = rand() % FB_HEIGHT;
+      fbLine(&fb, x, y, x1, y1, c);
+      int dx = abs(x1 - x), dy = abs(y1 - y);
+      return 1 + (dx > dy ? dx : dy);
+    }
+
+    case TEST_FILLED_CIRCLE:
+    {
+      int r = rand() % 64;
+      fbFilledCircle(&fb, x, y, r, c);
+      return (3 * r * r) + 1;   // roughly pi r squared, ignoring clipping
+    }
+
+    case TEST_BLIT:
+      fbBlit(&fb, x - 32, y - 32, blitImage, 32, 64, 64);
+      return 64 * 64;
+
+    default:
+      return 0;
+  }
+}
+
+int main(void)
+{
+  set_sys_clock_khz(240000, false);
+
+  stdio_init_all();
+
+  fbInit(&fb, frameBuffer, FB_WIDTH, FB_HEIGHT);
+  fbSetPalette(&fb, palette);
+  fbClear(&fb, 0);
+
+  // a test card to blit around
+  VgaFramebuffer image;
+  fbInit(&image, blitImage, 64, 64);
+  fbClear(&image, 1);
+  fbFilledCircle(&image, 32, 32, 28, 2);
+  fbCircle(&image, 32, 32, 31, 15);
+  fbLine(&image, 0, 0, 63, 63, 3);
+
+  VgaInitParams params = { 0 };
+  params.params = vgaGetParams(VGA_800_600_60HZ, 2);
+  params.scanlineFn = frameBufferScanline;
+
+  vgaInit(params);
+
+  while (1)
+  {
+    for (BenchTest test = 0; test < TEST_COUNT; ++test)
+    {
+      uint64_t pixels = 0;
+      uint32_t shapes = 0;
+      uint64_t start = time_us_64();
+      uint64_t elapsed = 0;
+
+      while (elapsed < TEST_US)
+      {
+        pixels += drawOne(test);
+        ++shapes;
+        elapsed = time_us_64() - start;
+      }
+
+      printf("%-16s %8lu shapes  %6lu Kpixels/s\n", testNames[test],
+        (unsigned long)shapes, (unsigned long)(pixels * 1000 / elapsed));
+    }
+    printf("\n");
+  }
+
+  return 0;
+}
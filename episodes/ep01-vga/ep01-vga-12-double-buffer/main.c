@@ -0,0 +1,120 @@
+/*
+ * Project: pico-56 - episode 1
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "vga.h"
+#include "vga-modes.h"
+#include "vga-framebuffer.h"
+
+#include "pico/stdlib.h"
+
+#include <stdlib.h>
+
+ /*
+  * bouncing balls in a double buffered 400x300x4bpp framebuffer. each frame
+  * the balls are erased and redrawn in the back buffer, then flipped. only
+  * the regions drawn are copied forward, so there's no full-buffer copy
+  */
+
+#define FB_WIDTH    400
+#define FB_HEIGHT   300
+#define BALLS       24
+#define BORDER      4
+
+uint8_t __aligned(4) frameBuffer0[FB_WIDTH / 2 * FB_HEIGHT];
+uint8_t __aligned(4) frameBuffer1[FB_WIDTH / 2 * FB_HEIGHT];
+VgaDoubleFramebuffer fb;
+
+static const uint16_t palette[FB_COLOURS] = {
+  0x000, 0x777, 0xf00, 0xff0, 0x0f0, 0x0ff, 0x00f, 0xf0f,
+  0x800, 0x880, 0x080, 0x088, 0x008, 0x808, 0xaaa, 0xfff
+};
+
+typedef struct
+{
+  int x, y;
+  int dx, dy;
+  int r;
+  uint8_t c;
+} Ball;
+
+Ball balls[BALLS];
+
+void frameBufferScanline(uint16_t y, VgaParams* params, uint16_t* pixels)
+{
+  fbDoubleScanline(&fb, y, pixels);
+}
+
+void endOfFrame(uint64_t frameNumber)
+{
+  fbDoubleEndOfFrame(&fb);
+}
+
+/*
+ * move a ball, bouncing off the border
+ */
+void moveBall(Ball* ball)
+{
+  ball->x += ball->dx;
+  ball->y += ball->dy;
+
+  if (ball->x - ball->r <= BORDER || ball->x + ball->r >= FB_WIDTH - 1 - BORDER) ball->dx = -ball->dx;
+  if (ball->y - ball->r <= BORDER || ball->y + ball->r >= FB_HEIGHT - 1 - BORDER) ball->dy = -ball->dy;
+}
+
+int main(void)
+{
+  set_sys_clock_khz(240000, false);
+
+  fbDoubleInit(&fb, frameBuffer0, frameBuffer1, FB_WIDTH, FB_HEIGHT);
+  fbDoubleSetPalette(&fb, palette);
+
+  for (int i = 0; i < BALLS; ++i)
+  {
+    Ball* ball = &balls[i];
+    ball->r = 6 + rand() % 18;
+    ball->x = BORDER + ball->r + 1 + rand() % (FB_WIDTH - 2 * (BORDER + ball->r + 1));
+    ball->y = BORDER + ball->r + 1 + rand() % (FB_HEIGHT - 2 * (BORDER + ball->r + 1));
+    ball->dx = (rand() & 1) ? (1 + rand() % 3) : -(1 + rand() % 3);
+    ball->dy = (rand() & 1) ? (1 + rand() % 3) : -(1 + rand() % 3);
+    ball->c = 2 + (i % 14);
+  }
+
+  VgaInitParams params = { 0 };
+  params.params = vgaGetParams(VGA_800_600_60HZ, 2);
+  params.scanlineFn = frameBufferScanline;
+  params.endOfFrameFn = endOfFrame;
+
+  vgaInit(params);
+
+  fbRect(fbBack(&fb), 0, 0, FB_WIDTH, FB_HEIGHT, 15);
+
+  while (1)
+  {
+    VgaFramebuffer* back = fbBack(&fb);
+
+    // the back buffer matches what's on screen, so erase where they were
+    for (int i = 0; i < BALLS; ++i)
+    {
+      fbFilledCircle(back, balls[i].x, balls[i].y, balls[i].r, 0);
+    }
+
+    for (int i = 0; i < BALLS; ++i)
+    {
+      moveBall(&balls[i]);
+      fbFilledCircle(back, balls[i].x, balls[i].y, balls[i].r, balls[i].c);
+      fbCircle(back, balls[i].x, balls[i].y, balls[i].r, 15);
+    }
+
+    fbFlip(&fb);
+  }
+
+  return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * Project: pico-56 - episode 1
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "vga.h"
+#include "vga-modes.h"
+#include "vga-sprite.h"
+#include "images.h"
+#include "sprites.h"
+
+#include "pico/stdlib.h"
+
+#include <memory.h>
+#include <stdio.h>
+
+ /*
+  * a handful of boing balls (with their alpha blended shadows) over the
+  * boing background using span-encoded sprites. the vga line timing stats
+  * are printed over usb serial every few seconds
+  */
+
+#define BALLS         6
+#define BALL_FRAMES   20
+#define BALL_SIZE     96
+#define FLOOR_Y       (240 - BALL_SIZE - 6)
+
+static const VgaSprite* ballSprites[BALL_FRAMES] = {
+  &ball00, &ball01, &ball02, &ball03, &ball04, &ball05, &ball06, &ball07, &ball08, &ball09,
+  &ball10, &ball11, &ball12, &ball13, &ball14, &ball15, &ball16, &ball17, &ball18, &ball19
+};
+
+typedef struct
+{
+  int x, y;         // 8.8 fixed point
+  int dx, dy;
+  int frame;
+  int frameStep;
+} Ball;
+
+Ball balls[BALLS];
+VgaSpriteList sprites;
+
+void spritesScanline(uint16_t y, VgaParams* params, uint16_t* pixels)
+{
+  memcpy(pixels, background + y * params->hVirtualPixels, params->hVirtualPixels * sizeof(uint16_t));
+  spriteListDrawLine(&sprites, y, pixels, params->hVirtualPixels);
+}
+
+/*
+ * move the balls and rebuild the sprite list for the next frame
+ */
+void endOfFrame(uint64_t frameNumber)
+{
+  spriteListClear(&sprites);
+
+  for (int i = 0; i < BALLS; ++i)
+  {
+    Ball* ball = &balls[i];
+
+    ball->dy += 64;     // gravity
+    ball->x += ball->dx;
+    ball->y += ball->dy;
+
+    if (ball->y > (FLOOR_Y << 8))
+    {
+      ball->y = FLOOR_Y << 8;
+      ball->dy = -ball->dy;
+    }
+
+    if (ball->x < (-16 << 8) || ball->x > ((320 - BALL_SIZE + 16) << 8))
+    {
+      ball->dx = -ball->dx;
+      ball->frameStep = -ball->frameStep;
+      ball->x += ball->dx;
+    }
+
+    ball->frame = (ball->frame + ball->frameStep + BALL_FRAMES) % BALL_FRAMES;
+    spriteListAdd(&sprites, ballSprites[ball->frame], ball->x >> 8, ball->y >> 8);
+  }
+}
+
+int main(void)
+{
+  set_sys_clock_khz(252000, false);
+
+  stdio_init_all();
+
+  for (int i = 0; i < BALLS; ++i)
+  {
+    Ball* ball = &balls[i];
+    ball->x = (i * 40) << 8;
+    ball->y = (i * 20) << 8;
+    ball->dx = (i & 1) ? 256 + i * 40 : -(256 + i * 40);
+    ball->dy = 0;
+    ball->frame = i * 3;
+    ball->frameStep = (i & 1) ? 1 : -1;
+  }
+
+  VgaInitParams params = { 0 };
+  params.params = vgaGetParams(VGA_640_480_60HZ, 2);
+  params.scanlineFn = spritesScanline;
+  params.endOfFrameFn = endOfFrame;
+
+  vgaInit(params);
+
+  while (1)
+  {
+    sleep_ms(5000);
+    vgaPrintStats();
+  }
+
+  return 0;
+}
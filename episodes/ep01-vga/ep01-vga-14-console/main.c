@@ -0,0 +1,142 @@
+/*
+ * Project: pico-56 - episode 1
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "vga.h"
+#include "vga-modes.h"
+#include "vga-console.h"
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+
+#include <stdio.h>
+
+ /*
+  * text console using the vga library directly (no tms9918). before the
+  * display starts, every line of a full screen is rendered on core0 and
+  * timed. the cycles per line are shown against the vga line budget
+  */
+
+// 100x37 at 800x600 rather than 80x30 at 640x480
+#ifndef CONSOLE_800_600
+#define CONSOLE_800_600 0
+#endif
+
+#if CONSOLE_800_600
+#define CONSOLE_MODE      VGA_800_600_60HZ
+#define CONSOLE_COLS      100
+#define CONSOLE_ROWS      37
+#define SYS_CLOCK_KHZ     240000
+#else
+#define CONSOLE_MODE      VGA_640_480_60HZ
+#define CONSOLE_COLS      80
+#define CONSOLE_ROWS      30
+#define SYS_CLOCK_KHZ     252000
+#endif
+
+#define FONT_HEIGHT       8
+#define MEASURE_FRAMES    100
+
+extern const uint8_t tmsFont[];
+extern const size_t tmsFontBytes;
+
+VgaConsole console;
+uint16_t __aligned(4) scratchLine[CONSOLE_COLS * 8];
+
+void consoleScanlineFn(uint16_t y, VgaParams* params, uint16_t* pixels)
+{
+  consoleScanline(&console, y, pixels);
+}
+
+void endOfFrame(uint64_t frameNumber)
+{
+  consoleEndOfFrame(&console);
+}
+
+/*
+ * average cycles to render a line of a full screen
+ */
+uint32_t measureLineCycles(uint16_t lines)
+{
+  uint64_t start = time_us_64();
+  for (int frame = 0; frame < MEASURE_FRAMES; ++frame)
+  {
+    for (uint16_t y = 0; y < lines; ++y)
+    {
+      consoleScanline(&console, y, scratchLine);
+    }
+  }
+  uint64_t elapsedUs = time_us_64() - start;
+
+  return (uint32_t)(elapsedUs * (clock_get_hz(clk_sys) / 1000000) / (MEASURE_FRAMES * lines));
+}
+
+int main(void)
+{
+  set_sys_clock_khz(SYS_CLOCK_KHZ, false);
+
+  stdio_init_all();
+
+  consoleInit(&console, CONSOLE_COLS, CONSOLE_ROWS, tmsFont, tmsFontBytes / FONT_HEIGHT, FONT_HEIGHT);
+
+  // fill the screen with every attribute so the timing is for a full screen
+  for (int y = 0; y < CONSOLE_ROWS; ++y)
+  {
+    for (int x = 0; x < CONSOLE_COLS; ++x)
+    {
+      consoleSetCell(&console, x, y, 'A' + ((x + y) % 26), (x + y * CONSOLE_COLS) & 0xff);
+    }
+  }
+
+  uint32_t lineCycles = measureLineCycles(CONSOLE_ROWS * FONT_HEIGHT);
+
+  // full width pixels, double height lines
+  VgaInitParams params = { 0 };
+  params.params = vgaGetParams(CONSOLE_MODE, 1);
+  params.params.vPixelScale = 2;
+  params.params.vVirtualPixels = params.params.vSyncParams.displayPixels / 2;
+  params.scanlineFn = consoleScanlineFn;
+  params.endOfFrameFn = endOfFrame;
+
+  vgaInit(params);
+
+  VgaStats stats = vgaCurrentStats();
+
+  consoleSetAttr(&console, CONSOLE_ATTR(15, 1));
+  consoleClear(&console);
+  consolePrintf(&console, "PICO-56 VGA CONSOLE  %dx%d\n\n", CONSOLE_COLS, CONSOLE_ROWS);
+
+  consoleSetAttr(&console, CONSOLE_ATTR(14, 1));
+  consolePrintf(&console, "RENDER: %d CYCLES PER LINE (BUDGET %d) AT %d MHZ\n\n",
+    lineCycles, stats.lineBudget, clock_get_hz(clk_sys) / 1000000);
+  printf("console: %d cycles per line (budget %d)\n", lineCycles, stats.lineBudget);
+
+  for (int bg = 0; bg < CONSOLE_COLOURS; ++bg)
+  {
+    for (int fg = 0; fg < CONSOLE_COLOURS; ++fg)
+    {
+      consoleSetAttr(&console, CONSOLE_ATTR(fg, bg));
+      consolePrintf(&console, " %X%X", bg, fg);
+    }
+    consoleSetAttr(&console, CONSOLE_ATTR(15, 1));
+    consolePutChar(&console, '\n');
+  }
+  consolePutChar(&console, '\n');
+
+  uint32_t seconds = 0;
+  while (1)
+  {
+    stats = vgaCurrentStats();
+    consolePrintf(&console, "%6d  FRAMES %8d  LATE LINES %d\n", seconds++, stats.frames, stats.lateLines);
+    sleep_ms(1000);
+  }
+
+  return 0;
+}
@@ -1,326 +1,589 @@
-/*
- * Project: pico-56 - boot menu
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-
-#include "tms9918.h"
-#include "sdcard.h"
-
-#include "vrEmuTms9918Util.h"
-
-#include "input.h"
-
-#include "pico/stdlib.h"
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-extern const uint8_t tmsFont[];
-extern const size_t tmsFontBytes;
-
-extern uint8_t* romPtr();
-extern size_t romSize();
-
-#define FILE_PATTERN "*.o"
-#define PAGE_SIZE 16
-
-static int fileCount = 0;
-
-/*
- * Load a page of file metadata from the sdcard
- */
-bool loadPage(uint16_t pageNumber, FILINFO fileList[PAGE_SIZE])
-{
-  DIR d;
-  FILINFO fno;
-  memset(&d, 0, sizeof d);
-  memset(&fno, 0, sizeof fno);
-  memset(fileList, 0, sizeof(FILINFO) * PAGE_SIZE);
-
-
-  int index = 0;
-  FRESULT fr = f_findfirst(&d, &fno, ".", FILE_PATTERN);
-
-  int fromIndex = pageNumber * PAGE_SIZE;
-  int toIndex = fromIndex + PAGE_SIZE;
-  bool status = false;
-
-  while ((FR_OK == fr) && fno.fname[0])
-  {
-    if (index >= fromIndex && (index < toIndex))
-    {
-      fileList[index - fromIndex] = fno;
-      status = true;
-    }
-
-    index++;
-    fr = f_findnext(&d, &fno);
-  }
-
-  fileCount = index;
-
-  return status;
-}
-
-/*
- * Render the current page of file metadata to the tms9918
- */
-void renderPage(FILINFO fileList[PAGE_SIZE], int currentIndex, int currentPage)
-{
-  VrEmuTms9918* tms9918 = getTms9918();
-
-  char fileName[32];
-  sprintf(fileName, "Pg %d/%d", currentPage + 1, fileCount / PAGE_SIZE + 1);
-
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + (32 * 3) + 24);
-  vrEmuTms9918WriteString(tms9918, fileName);
-
-  for (int i = 0; i < PAGE_SIZE; ++i)
-  {
-    char c = i + '0';
-    if (i > 9) c += 7;
-
-    memset(fileName, ' ', sizeof(fileName));
-    fileName[30] = '\0';
-    if (fileList[i].fname[0])
-    {
-      sprintf(fileName, "%c%-18.18s %7d B ", (currentIndex == i) ? '>' : ' ', fileList[i].fname, fileList[i].fsize);
-    }
-
-    vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + (32 * 5) + (32 * i) + 1);
-    vrEmuTms9918WriteStringOffset(tms9918, fileName, (currentIndex == i) ? 128 : 0);
-  }
-}
-
-/*
- * Render the boot menu (except for the main list)
- */
-void renderBootMenu()
-{
-  VrEmuTms9918* tms9918 = getTms9918();
-
-  vrEmuTms9918InitialiseGfxI(tms9918);
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_COLOR_ADDRESS);
-  vrEmuTms9918SetFgBgColor(tms9918, TMS_WHITE, TMS_DK_BLUE);
-  vrEmuTms9918WriteByteRpt(tms9918, vrEmuTms9918FgBgColor(TMS_DK_BLUE, TMS_WHITE), 16);
-  vrEmuTms9918WriteByteRpt(tms9918, vrEmuTms9918FgBgColor(TMS_WHITE, TMS_DK_BLUE), 16);
-
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_PATT_ADDRESS);
-  vrEmuTms9918WriteBytes(tms9918, tmsFont, tmsFontBytes);
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_PATT_ADDRESS + 128 * 8);
-  vrEmuTms9918WriteBytes(tms9918, tmsFont, tmsFontBytes);
-
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 + 1);
-  for (int i = 20; i < 27; ++i)
-    vrEmuTms9918WriteData(tms9918, i);
-  vrEmuTms9918WriteString(tms9918, "    Boot Menu      v"PICO56_VERSION);
-
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS);
-  vrEmuTms9918WriteByteRpt(tms9918, ' ' - 5, 32);
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 23);
-  vrEmuTms9918WriteByteRpt(tms9918, 128 + ' ' - 5, 32);
-
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 2);
-  vrEmuTms9918WriteByteRpt(tms9918, '~' + 1, 32);
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 21);
-  vrEmuTms9918WriteByteRpt(tms9918, '~' + 1, 32);
-
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 4);
-  vrEmuTms9918WriteData(tms9918, 32 - 4);
-  vrEmuTms9918WriteByteRpt(tms9918, '~' + 1, 30);
-  vrEmuTms9918WriteData(tms9918, 32 - 2);
-
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 5);
-  vrEmuTms9918WriteData(tms9918, '|');
-  for (int i = 6; i < 16 + 6; ++i)
-  {
-    vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * i - 1);
-    vrEmuTms9918WriteData(tms9918, '|');
-    vrEmuTms9918WriteData(tms9918, '|');
-  }
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 21);
-  vrEmuTms9918WriteData(tms9918, 32 - 3);
-  vrEmuTms9918WriteByteRpt(tms9918, '~' + 1, 30);
-  vrEmuTms9918WriteData(tms9918, 32 - 1);
-
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 22 + 3);
-  vrEmuTms9918WriteString(tms9918, "github.com/visrealm/pico-56");
-}
-
-/*
- * Run the boot menu. Optionally update the ROM image
- */
-void runBootMenu()
-{
-  renderBootMenu();
-
-  int currentPage = 0;
-  int currentIndex = 0;
-  int renderedPage = -1;
-
-  VrEmuTms9918* tms9918 = getTms9918();
-
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 3 + 1);
-  vrEmuTms9918WriteString(tms9918, "Checking for MicroSD...");
-
-  sd_card_t *sdc = sd_get_by_num(0);
-  FRESULT fr = f_mount(&sdc->state.fatfs, "", 1);
-
-  TCHAR label[255] = "Not present";
-  DWORD vsn = 0;
-  char fileName[FF_MAX_LFN + 10];
-
-  f_getlabel("", label, &vsn);
-  if (!label[0]) strcpy(label, "<no label>");
-
-  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 3 + 1);
-  sprintf(fileName, "MicroSD: %-20.20s", label);
-  vrEmuTms9918WriteString(tms9918, fileName);
-
-  FILINFO* fileList = malloc(sizeof(FILINFO) * PAGE_SIZE);
-  bool status = false;
-
-  if (fr == FR_OK)
-  {
-    status = loadPage(currentPage, fileList);
-  }
-
-  if (!status)
-  {
-    free(fileList);
-    sleep_ms(1000);
-    vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 5 + 1);
-    vrEmuTms9918WriteString(tms9918, "Starting BASIC...");
-    sleep_ms(2000);
-    return;
-  }
-
-  printf("PICO-56 boot menu\n");
-
-  uint8_t lastScancode = 0;
-  renderPage(fileList, currentIndex, currentPage);
-
-  int uiUpdateIndex = 0;
-  absolute_time_t nextUiUpdate = get_absolute_time();
-
-  while (status)
-  {
-    BootMenuInput inp = currentInput();
-
-    if (inp == BMI_DOWN)
-    {
-      if (currentIndex < PAGE_SIZE - 1)
-      {
-        if (fileList[currentIndex + 1].fname[0])
-        {
-          ++currentIndex;
-          renderPage(fileList, currentIndex, currentPage);
-          sleep_ms(150);
-        }
-      }
-      else
-      {
-        inp = BMI_PGDOWN;
-      }
-    }
-    else if (inp == BMI_UP)
-    {
-      if (currentIndex > 0)
-      {
-        --currentIndex;
-        renderPage(fileList, currentIndex, currentPage);
-        sleep_ms(150);
-      }
-      else
-      {
-        inp = BMI_PGUP;
-      }
-    }
-
-    if (inp == BMI_PGDOWN)
-    {
-      if (loadPage(currentPage + 1, fileList))
-      {
-        ++currentPage;
-        currentIndex = 0;
-      }
-      else
-      {
-        loadPage(currentPage, fileList);
-      }
-      renderPage(fileList, currentIndex, currentPage);
-      sleep_ms(150);
-    }
-    else if (inp == BMI_PGUP)
-    {
-      if (loadPage(currentPage - 1, fileList))
-      {
-        --currentPage;
-        currentIndex = 0;
-      }
-      else
-      {
-        loadPage(currentPage, fileList);
-      }
-      renderPage(fileList, currentIndex, currentPage);
-      sleep_ms(150);
-    }
-    else if (inp == BMI_SELECT)
-    {
-      break;
-    }
-
-    // update bottom message
-    absolute_time_t currentTime = get_absolute_time();
-    if (to_us_since_boot(currentTime) > to_us_since_boot(nextUiUpdate))
-    {
-      nextUiUpdate = delayed_by_ms(currentTime, 5000);
-      vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 22);
-      if (++uiUpdateIndex & 0x01)
-      {
-        vrEmuTms9918WriteString(tms9918, "   github.com/visrealm/pico-56");
-      }
-      else
-      {
-        vrEmuTms9918WriteString(tms9918, "      \x13 2024 Troy Schrapel    ");
-      }
-    }
-  }
-
-  memset(fileList, 0, sizeof(FILINFO) * PAGE_SIZE);
-  renderPage(fileList, -1, currentPage);
-  loadPage(currentPage, fileList);
-
-  if (status)
-  {
-    vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 5 + 1);
-    vrEmuTms9918WriteString(tms9918, "Loading ");
-    vrEmuTms9918WriteString(tms9918, fileList[currentIndex].fname);
-
-    printf("Loading %s...\n", fileList[currentIndex].fname);
-
-    FIL fil;
-    fr = f_open(&fil, fileList[currentIndex].fname, FA_OPEN_EXISTING | FA_READ);
-    if (fr == FR_OK || fr == FR_EXIST)
-    {
-      unsigned int nr;
-      fr = f_read(&fil, (void*)romPtr(), romSize(), &nr);			/* Read data from the file */
-    }
-
-    vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 5 + 1);
-    vrEmuTms9918WriteString(tms9918, (FR_OK == fr) ? "Loaded " : "Error loading ");
-    vrEmuTms9918WriteString(tms9918, fileList[currentIndex].fname);
-    vrEmuTms9918WriteString(tms9918, "    ");
-    sleep_ms(1000);
-
-  }
-  free(fileList);
-}
+/*
+ * Project: pico-56 - boot menu
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "boot-menu.h"
+
+#include "tms9918.h"
+#include "sdcard.h"
+#include "ps2-kbd.h"
+#include "nes-ctrl.h"
+
+#include "vrEmuTms9918Util.h"
+
+#include "input.h"
+#include "rom-library.h"
+#include "settings.h"
+
+#include "pico/stdlib.h"
+#include "hardware/watchdog.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern const uint8_t tmsFont[];
+extern const size_t tmsFontBytes;
+
+extern uint8_t* romPtr();
+extern size_t romSize();
+
+#define FILE_PATTERN "*.o"
+#define REPLAY_EXTENSION ".rec"
+#define PAGE_SIZE 16
+#define QUICK_BOOT_FRAMES 2           // frames of input polling before the quick boot
+#define QUICK_BOOT_DELAY_MS 750       // how long to wait for a menu key when the keyboard is active
+
+#define SHOW_MENU_SCRATCH 0           // watchdog scratch register
+#define SHOW_MENU_MAGIC   0x4d454e55  // skip the quick boot after a settings restart
+
+static int fileCount = 0;
+static int librarySlots[PAGE_SIZE];   // flash library slot of each listed rom
+
+/*
+ * Load a page of file metadata from the sdcard
+ */
+bool loadPage(uint16_t pageNumber, FILINFO fileList[PAGE_SIZE])
+{
+  DIR d;
+  FILINFO fno;
+  memset(&d, 0, sizeof d);
+  memset(&fno, 0, sizeof fno);
+  memset(fileList, 0, sizeof(FILINFO) * PAGE_SIZE);
+
+
+  int index = 0;
+  FRESULT fr = f_findfirst(&d, &fno, ".", FILE_PATTERN);
+
+  int fromIndex = pageNumber * PAGE_SIZE;
+  int toIndex = fromIndex + PAGE_SIZE;
+  bool status = false;
+
+  while ((FR_OK == fr) && fno.fname[0])
+  {
+    if (index >= fromIndex && (index < toIndex))
+    {
+      fileList[index - fromIndex] = fno;
+      status = true;
+    }
+
+    index++;
+    fr = f_findnext(&d, &fno);
+  }
+
+  fileCount = index;
+
+  return status;
+}
+
+/*
+ * Load the roms stored in the flash library (as file metadata)
+ */
+bool loadLibraryPage(FILINFO fileList[PAGE_SIZE])
+{
+  memset(fileList, 0, sizeof(FILINFO) * PAGE_SIZE);
+
+  int index = 0;
+  for (int slot = 0; slot < ROM_LIBRARY_SLOTS && index < PAGE_SIZE; ++slot)
+  {
+    const RomLibraryEntry* entry = romLibraryEntry(slot);
+    if (entry)
+    {
+      strncpy(fileList[index].fname, entry->name, sizeof(fileList[index].fname) - 1);
+      fileList[index].fsize = entry->size;
+      librarySlots[index++] = slot;
+    }
+  }
+
+  fileCount = index;
+
+  return index != 0;
+}
+
+/*
+ * Render the current rom source (sdcard label or flash library)
+ */
+void renderSource(bool showLibrary, const char* label)
+{
+  VrEmuTms9918* tms9918 = getTms9918();
+
+  char source[32];
+  if (showLibrary)
+  {
+    sprintf(source, "Flash: %-22.22s", "\x1b \x1a for MicroSD");
+  }
+  else
+  {
+    sprintf(source, "MicroSD: %-20.20s", label);
+  }
+
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 3 + 1);
+  vrEmuTms9918WriteString(tms9918, source);
+}
+
+/*
+ * Render the current page of file metadata to the tms9918
+ */
+void renderPage(FILINFO fileList[PAGE_SIZE], int currentIndex, int currentPage)
+{
+  VrEmuTms9918* tms9918 = getTms9918();
+
+  char fileName[32];
+  sprintf(fileName, "Pg %d/%d", currentPage + 1, fileCount / PAGE_SIZE + 1);
+
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + (32 * 3) + 24);
+  vrEmuTms9918WriteString(tms9918, fileName);
+
+  for (int i = 0; i < PAGE_SIZE; ++i)
+  {
+    char c = i + '0';
+    if (i > 9) c += 7;
+
+    memset(fileName, ' ', sizeof(fileName));
+    fileName[30] = '\0';
+    if (fileList[i].fname[0])
+    {
+      sprintf(fileName, "%c%-18.18s %7d B ", (currentIndex == i) ? '>' : ' ', fileList[i].fname, fileList[i].fsize);
+    }
+
+    vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + (32 * 5) + (32 * i) + 1);
+    vrEmuTms9918WriteStringOffset(tms9918, fileName, (currentIndex == i) ? 128 : 0);
+  }
+}
+
+/*
+ * Render the boot menu (except for the main list)
+ */
+void renderBootMenu()
+{
+  VrEmuTms9918* tms9918 = getTms9918();
+
+  vrEmuTms9918InitialiseGfxI(tms9918);
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_COLOR_ADDRESS);
+  vrEmuTms9918SetFgBgColor(tms9918, TMS_WHITE, TMS_DK_BLUE);
+  vrEmuTms9918WriteByteRpt(tms9918, vrEmuTms9918FgBgColor(TMS_DK_BLUE, TMS_WHITE), 16);
+  vrEmuTms9918WriteByteRpt(tms9918, vrEmuTms9918FgBgColor(TMS_WHITE, TMS_DK_BLUE), 16);
+
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_PATT_ADDRESS);
+  vrEmuTms9918WriteBytes(tms9918, tmsFont, tmsFontBytes);
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_PATT_ADDRESS + 128 * 8);
+  vrEmuTms9918WriteBytes(tms9918, tmsFont, tmsFontBytes);
+
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 + 1);
+  for (int i = 20; i < 27; ++i)
+    vrEmuTms9918WriteData(tms9918, i);
+  vrEmuTms9918WriteString(tms9918, "    Boot Menu      v"PICO56_VERSION);
+
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS);
+  vrEmuTms9918WriteByteRpt(tms9918, ' ' - 5, 32);
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 23);
+  vrEmuTms9918WriteByteRpt(tms9918, 128 + ' ' - 5, 32);
+
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 2);
+  vrEmuTms9918WriteByteRpt(tms9918, '~' + 1, 32);
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 21);
+  vrEmuTms9918WriteByteRpt(tms9918, '~' + 1, 32);
+
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 4);
+  vrEmuTms9918WriteData(tms9918, 32 - 4);
+  vrEmuTms9918WriteByteRpt(tms9918, '~' + 1, 30);
+  vrEmuTms9918WriteData(tms9918, 32 - 2);
+
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 5);
+  vrEmuTms9918WriteData(tms9918, '|');
+  for (int i = 6; i < 16 + 6; ++i)
+  {
+    vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * i - 1);
+    vrEmuTms9918WriteData(tms9918, '|');
+    vrEmuTms9918WriteData(tms9918, '|');
+  }
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 21);
+  vrEmuTms9918WriteData(tms9918, 32 - 3);
+  vrEmuTms9918WriteByteRpt(tms9918, '~' + 1, 30);
+  vrEmuTms9918WriteData(tms9918, 32 - 1);
+
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 22 + 3);
+  vrEmuTms9918WriteString(tms9918, "github.com/visrealm/pico-56");
+}
+
+/*
+ * input log file name for a rom (GAME.o -> GAME.rec)
+ */
+static void replayFileName(const char* romFile, char* replayFile)
+{
+  snprintf(replayFile, BOOT_MENU_MAX_FILENAME - sizeof(REPLAY_EXTENSION), "%s", romFile);
+  char* ext = strrchr(replayFile, '.');
+  if (ext) *ext = '\0';
+  strcat(replayFile, REPLAY_EXTENSION);
+}
+
+/*
+ * Has any key (a make code) or nes button been pressed? Drains the keyboard
+ * queue. Keyboard power-on and ack bytes don't count
+ */
+static bool anyKeyPressed(bool* keyboardActive)
+{
+  static uint8_t lastScancode = 0;
+  bool pressed = false;
+
+  while (!kbdQueueEmpty())
+  {
+    uint8_t scancode = kbdQueuePop();
+    *keyboardActive = true;
+
+    if (lastScancode != 0xf0 && scancode != 0xf0 && scancode != 0xe0 &&
+        scancode != 0xaa && scancode != 0xfa)
+    {
+      pressed = true;
+    }
+    lastScancode = scancode;
+  }
+
+  return pressed || nes_get_state_1() != 0xff;
+}
+
+/*
+ * Boot the last used rom straight from the flash library unless a key or
+ * button is held (or pressed while the keyboard is active)
+ */
+static bool quickBoot()
+{
+  if (watchdog_hw->scratch[SHOW_MENU_SCRATCH] == SHOW_MENU_MAGIC)
+  {
+    watchdog_hw->scratch[SHOW_MENU_SCRATCH] = 0;
+    return false;
+  }
+
+  int slot = romLibraryLastUsed();
+  if (slot < 0) return false;
+
+  VrEmuTms9918* tms9918 = getTms9918();
+
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 3 + 1);
+  vrEmuTms9918WriteString(tms9918, "Booting ");
+  vrEmuTms9918WriteString(tms9918, romLibraryEntry(slot)->name);
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 5 + 1);
+  vrEmuTms9918WriteString(tms9918, "Hold any key for menu");
+
+  // input is polled once a frame, so give it a couple of frames. then only
+  // wait for a menu key if the keyboard has actually sent something
+  bool keyboardActive = false;
+  bool polled = false;
+  uint32_t startFrame = tmsVblankCount();
+  absolute_time_t bootTime = get_absolute_time();
+  while (!polled || !time_reached(bootTime))
+  {
+    if (anyKeyPressed(&keyboardActive))
+    {
+      vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 5 + 1);
+      vrEmuTms9918WriteString(tms9918, "                      ");
+      return false;
+    }
+
+    if (!polled && tmsVblankCount() - startFrame >= QUICK_BOOT_FRAMES)
+    {
+      polled = true;
+      bootTime = make_timeout_time_ms(keyboardActive ? QUICK_BOOT_DELAY_MS : 0);
+    }
+  }
+
+  if (!romLibraryLoad(slot, romPtr(), romSize())) return false;
+
+  // the sdcard is mounted on first use (by the running rom)
+  sd_card_t* sdc = sd_get_by_num(0);
+  f_mount(&sdc->state.fatfs, "", 0);
+
+  printf("Booted %s from flash\n", romLibraryEntry(slot)->name);
+  return true;
+}
+
+/*
+ * Switch to the next display mode. Saves the setting and restarts
+ * (back to the menu) to apply it
+ */
+static void nextVideoMode()
+{
+  Settings settings = *settingsCurrent();
+  settingsNextVgaMode(&settings);
+
+  VrEmuTms9918* tms9918 = getTms9918();
+  char message[32];
+  snprintf(message, sizeof(message), "Video: %-22.22s", settingsVgaModeName(&settings));
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 3 + 1);
+  vrEmuTms9918WriteString(tms9918, message);
+
+  printf("Switching to %s\n", settingsVgaModeName(&settings));
+
+  settingsSave(&settings);
+  sleep_ms(500);
+
+  watchdog_hw->scratch[SHOW_MENU_SCRATCH] = SHOW_MENU_MAGIC;
+  watchdog_reboot(0, 0, 0);
+  while (1)
+  {
+    tight_loop_contents();
+  }
+}
+
+/*
+ * Run the boot menu. Optionally update the ROM image
+ */
+void runBootMenu(BootOptions* options)
+{
+  renderBootMenu();
+
+  if (quickBoot()) return;
+
+  int currentPage = 0;
+  int currentIndex = 0;
+  int renderedPage = -1;
+
+  VrEmuTms9918* tms9918 = getTms9918();
+
+  vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 3 + 1);
+  vrEmuTms9918WriteString(tms9918, "Checking for MicroSD...");
+
+  sd_card_t *sdc = sd_get_by_num(0);
+  FRESULT fr = f_mount(&sdc->state.fatfs, "", 1);
+
+  TCHAR label[255] = "Not present";
+  DWORD vsn = 0;
+
+  f_getlabel("", label, &vsn);
+  if (!label[0]) strcpy(label, "<no label>");
+
+  renderSource(false, label);
+
+  FILINFO* fileList = malloc(sizeof(FILINFO) * PAGE_SIZE);
+  bool status = false;
+  bool showLibrary = false;
+
+  if (fr == FR_OK)
+  {
+    status = loadPage(currentPage, fileList);
+  }
+
+  // no sdcard? use the flash library
+  if (!status)
+  {
+    status = showLibrary = loadLibraryPage(fileList);
+    if (showLibrary) renderSource(showLibrary, label);
+  }
+
+  if (!status)
+  {
+    free(fileList);
+    sleep_ms(1000);
+    vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 5 + 1);
+    vrEmuTms9918WriteString(tms9918, "Starting BASIC...");
+    sleep_ms(2000);
+    return;
+  }
+
+  printf("PICO-56 boot menu\n");
+
+  uint8_t lastScancode = 0;
+  renderPage(fileList, currentIndex, currentPage);
+
+  int uiUpdateIndex = 0;
+  absolute_time_t nextUiUpdate = get_absolute_time();
+
+  while (status)
+  {
+    BootMenuInput inp = currentInput();
+
+    if (inp == BMI_DOWN)
+    {
+      if (currentIndex < PAGE_SIZE - 1)
+      {
+        if (fileList[currentIndex + 1].fname[0])
+        {
+          ++currentIndex;
+          renderPage(fileList, currentIndex, currentPage);
+          sleep_ms(150);
+        }
+      }
+      else if (!showLibrary)
+      {
+        inp = BMI_PGDOWN;
+      }
+    }
+    else if (inp == BMI_UP)
+    {
+      if (currentIndex > 0)
+      {
+        --currentIndex;
+        renderPage(fileList, currentIndex, currentPage);
+        sleep_ms(150);
+      }
+      else if (!showLibrary)
+      {
+        inp = BMI_PGUP;
+      }
+    }
+    else if (inp == BMI_LEFT || inp == BMI_RIGHT)
+    {
+      // switch between the sdcard and the flash library
+      bool switched = showLibrary
+        ? (fr == FR_OK) && loadPage(0, fileList)
+        : loadLibraryPage(fileList);
+
+      if (switched)
+      {
+        showLibrary = !showLibrary;
+        currentPage = 0;
+        currentIndex = 0;
+        renderSource(showLibrary, label);
+      }
+      renderPage(fileList, currentIndex, currentPage);
+      sleep_ms(150);
+    }
+
+    if (showLibrary)
+    {
+      // the library is a single page
+    }
+    else if (inp == BMI_PGDOWN)
+    {
+      if (loadPage(currentPage + 1, fileList))
+      {
+        ++currentPage;
+        currentIndex = 0;
+      }
+      else
+      {
+        loadPage(currentPage, fileList);
+      }
+      renderPage(fileList, currentIndex, currentPage);
+      sleep_ms(150);
+    }
+    else if (inp == BMI_PGUP)
+    {
+      if (loadPage(currentPage - 1, fileList))
+      {
+        --currentPage;
+        currentIndex = 0;
+      }
+      else
+      {
+        loadPage(currentPage, fileList);
+      }
+      renderPage(fileList, currentIndex, currentPage);
+      sleep_ms(150);
+    }
+
+    if (inp == BMI_SELECT)
+    {
+      break;
+    }
+    else if (inp == BMI_RECORD)
+    {
+      options->recordInput = true;
+      break;
+    }
+    else if (inp == BMI_PLAYBACK)
+    {
+      options->replayInput = true;
+      break;
+    }
+    else if (inp == BMI_VIDEO_MODE)
+    {
+      nextVideoMode();
+    }
+
+    // update bottom message
+    absolute_time_t currentTime = get_absolute_time();
+    if (to_us_since_boot(currentTime) > to_us_since_boot(nextUiUpdate))
+    {
+      nextUiUpdate = delayed_by_ms(currentTime, 5000);
+      vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 22);
+      switch (++uiUpdateIndex % 4)
+      {
+        case 0:
+          vrEmuTms9918WriteString(tms9918, "   github.com/visrealm/pico-56");
+          break;
+        case 1:
+          vrEmuTms9918WriteString(tms9918, "      \x13 2024 Troy Schrapel    ");
+          break;
+        case 2:
+          vrEmuTms9918WriteString(tms9918, "   R: record   P: replay input ");
+          break;
+        default:
+        {
+          char message[33];
+          snprintf(message, sizeof(message), "   V: video %-19.19s", settingsVgaModeName(settingsCurrent()));
+          vrEmuTms9918WriteString(tms9918, message);
+          break;
+        }
+      }
+    }
+  }
+
+  memset(fileList, 0, sizeof(FILINFO) * PAGE_SIZE);
+  renderPage(fileList, -1, currentPage);
+  if (showLibrary)
+  {
+    loadLibraryPage(fileList);
+  }
+  else
+  {
+    loadPage(currentPage, fileList);
+  }
+
+  if (status)
+  {
+    vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 5 + 1);
+    vrEmuTms9918WriteString(tms9918, "Loading ");
+    vrEmuTms9918WriteString(tms9918, fileList[currentIndex].fname);
+
+    printf("Loading %s...\n", fileList[currentIndex].fname);
+
+    if (showLibrary)
+    {
+      fr = romLibraryLoad(librarySlots[currentIndex], romPtr(), romSize()) ? FR_OK : FR_INT_ERR;
+    }
+    else
+    {
+      FIL fil;
+      fr = f_open(&fil, fileList[currentIndex].fname, FA_OPEN_EXISTING | FA_READ);
+      if (fr == FR_OK || fr == FR_EXIST)
+      {
+        unsigned int nr;
+        fr = f_read(&fil, (void*)romPtr(), romSize(), &nr);			/* Read data from the file */
+        f_close(&fil);
+      }
+
+      // keep a copy in flash for next time
+      if (fr == FR_OK)
+      {
+        vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 5 + 1);
+        vrEmuTms9918WriteString(tms9918, "Storing ");
+        vrEmuTms9918WriteString(tms9918, fileList[currentIndex].fname);
+        romLibraryStore(fileList[currentIndex].fname, romPtr(), romSize());
+      }
+    }
+
+    vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 5 + 1);
+    vrEmuTms9918WriteString(tms9918, (FR_OK == fr) ? "Loaded " : "Error loading ");
+    vrEmuTms9918WriteString(tms9918, fileList[currentIndex].fname);
+    vrEmuTms9918WriteString(tms9918, "    ");
+
+    if (options->recordInput || options->replayInput)
+    {
+      replayFileName(fileList[currentIndex].fname, options->replayFile);
+      vrEmuTms9918SetAddressWrite(tms9918, TMS_DEFAULT_VRAM_NAME_ADDRESS + 32 * 6 + 1);
+      vrEmuTms9918WriteString(tms9918, options->recordInput ? "Recording " : "Replaying ");
+      vrEmuTms9918WriteString(tms9918, options->replayFile);
+    }
+    sleep_ms(1000);
+
+  }
+  free(fileList);
+}
@@ -1,17 +1,28 @@
-/*
- * Project: pico-56 - boot menu
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-#pragma once
-
-/*
- * Run the boot menu. Optionally update the ROM image
- */
-void runBootMenu();
\ No newline at end of file
+/*
+ * Project: pico-56 - boot menu
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#define BOOT_MENU_MAX_FILENAME 64
+
+typedef struct
+{
+  bool recordInput;   // record input to replayFile
+  bool replayInput;   // replay input from replayFile
+  char replayFile[BOOT_MENU_MAX_FILENAME];
+} BootOptions;
+
+/*
+ * Run the boot menu. Optionally update the ROM image
+ */
+void runBootMenu(BootOptions* options);
\ No newline at end of file
@@ -0,0 +1,53 @@
+/*
+ * Project: pico-56 - boot menu flash storage
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "flash-store.h"
+
+#include "vga.h"
+
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+
+/*
+ * run a flash operation
+ *  - core1 is parked (in ram) and then locked out, and interrupts are
+ *    disabled while flash is unavailable
+ */
+static void flashStoreOp(uint32_t offset, size_t eraseSize, const uint8_t* data, size_t size)
+{
+  vgaPark();
+  multicore_lockout_start_blocking();
+  uint32_t ints = save_and_disable_interrupts();
+
+  if (eraseSize) flash_range_erase(offset, eraseSize);
+  if (size) flash_range_program(offset, data, size);
+
+  restore_interrupts(ints);
+  multicore_lockout_end_blocking();
+  vgaUnpark();
+}
+
+/*
+ * erase and program a region of flash
+ */
+void flashStoreWrite(uint32_t offset, size_t eraseSize, const uint8_t* data, size_t size)
+{
+  flashStoreOp(offset, eraseSize, data, size);
+}
+
+/*
+ * program (whole pages of) already erased flash
+ */
+void flashStoreProgram(uint32_t offset, const uint8_t* data, size_t size)
+{
+  flashStoreOp(offset, 0, data, size);
+}
@@ -0,0 +1,49 @@
+/*
+ * Project: pico-56 - boot menu flash storage
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include "rom-library.h"
+
+#include "hardware/flash.h"
+
+#include <inttypes.h>
+#include <stddef.h>
+
+ /*
+  * boot menu storage lives at the end of flash:
+  *
+  *   +-----------------+--------------+--------+-----+--------+
+  *   | settings sector | index sector | slot 0 | ... | slot N |
+  *   +-----------------+--------------+--------+-----+--------+
+  *                     |<----------- rom library ------------>|
+  */
+
+#define FLASH_STORE_LIBRARY_SIZE     (FLASH_SECTOR_SIZE + ROM_LIBRARY_SLOTS * ROM_LIBRARY_SLOT_SIZE)
+#define FLASH_STORE_LIBRARY_OFFSET   (PICO_FLASH_SIZE_BYTES - FLASH_STORE_LIBRARY_SIZE)
+#define FLASH_STORE_SETTINGS_SIZE    FLASH_SECTOR_SIZE
+#define FLASH_STORE_SETTINGS_OFFSET  (FLASH_STORE_LIBRARY_OFFSET - FLASH_STORE_SETTINGS_SIZE)
+#define FLASH_STORE_SIZE             (FLASH_STORE_SETTINGS_SIZE + FLASH_STORE_LIBRARY_SIZE)
+
+// the linker reserves PICO56_FLASH_STORE_SIZE (see flash-store.ld)
+#ifdef PICO56_FLASH_STORE_SIZE
+_Static_assert(FLASH_STORE_SIZE == PICO56_FLASH_STORE_SIZE, "flash store size doesn't match the linker reservation");
+#endif
+
+/*
+ * erase and program a region of flash
+ */
+void flashStoreWrite(uint32_t offset, size_t eraseSize, const uint8_t* data, size_t size);
+
+/*
+ * program (whole pages of) already erased flash
+ */
+void flashStoreProgram(uint32_t offset, const uint8_t* data, size_t size);
@@ -0,0 +1,303 @@
+/*
+ * Project: pico-56 - boot menu rom library
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "rom-library.h"
+#include "flash-store.h"
+
+#include "pico/stdlib.h"
+
+#include <string.h>
+
+ /*
+  * the library lives at the end of flash (see flash-store.h):
+  *
+  *   +--------------+--------+--------+-----+--------+
+  *   | index sector | slot 0 | slot 1 | ... | slot N |
+  *   +--------------+--------+--------+-----+--------+
+  *
+  * stored roms are read directly through xip, so switching is a 32KB copy
+  *
+  * the rest of the index sector (after the index) is a log of last used
+  * slots, one byte each, programmed without an erase. the newest entry is
+  * the last used slot. the log is folded into the index (and cleared) when
+  * the index is next written, or when it fills up
+  */
+
+#define ROM_LIBRARY_MAGIC       0x35364c52  /* "RL65" */
+#define ROM_LIBRARY_INDEX_SIZE  FLASH_SECTOR_SIZE
+#define ROM_LIBRARY_OFFSET      FLASH_STORE_LIBRARY_OFFSET
+
+typedef struct
+{
+  uint32_t magic;
+  uint32_t sequence;      // incremented each time a rom is used
+  RomLibraryEntry entries[ROM_LIBRARY_SLOTS];
+} RomLibraryIndex;
+
+// index is programmed in whole pages
+#define ROM_LIBRARY_INDEX_BYTES ((sizeof(RomLibraryIndex) + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1))
+
+static uint8_t __aligned(4) indexBuffer[ROM_LIBRARY_INDEX_BYTES];
+
+#define ROM_LIBRARY_LOG_OFFSET  ROM_LIBRARY_INDEX_BYTES
+#define ROM_LIBRARY_LOG_SIZE    (ROM_LIBRARY_INDEX_SIZE - ROM_LIBRARY_LOG_OFFSET)
+#define ROM_LIBRARY_LOG_EMPTY   0xff
+
+/*
+ * the index in flash
+ */
+static inline const RomLibraryIndex* flashIndex()
+{
+  return (const RomLibraryIndex*)(XIP_BASE + ROM_LIBRARY_OFFSET);
+}
+
+/*
+ * a slot in flash
+ */
+static inline const uint8_t* flashSlot(int slot)
+{
+  return (const uint8_t*)(XIP_BASE + ROM_LIBRARY_OFFSET + ROM_LIBRARY_INDEX_SIZE + slot * ROM_LIBRARY_SLOT_SIZE);
+}
+
+/*
+ * the last used log in flash
+ */
+static inline const uint8_t* flashLog()
+{
+  return (const uint8_t*)(XIP_BASE + ROM_LIBRARY_OFFSET + ROM_LIBRARY_LOG_OFFSET);
+}
+
+/*
+ * number of entries in the last used log (it fills from the start)
+ */
+static int logCount()
+{
+  const uint8_t* log = flashLog();
+  int lo = 0, hi = ROM_LIBRARY_LOG_SIZE;
+  while (lo < hi)
+  {
+    int mid = (lo + hi) / 2;
+    if (log[mid] == ROM_LIBRARY_LOG_EMPTY) hi = mid;
+    else lo = mid + 1;
+  }
+  return lo;
+}
+
+/*
+ * is the index in flash valid?
+ */
+static inline bool indexValid()
+{
+  return flashIndex()->magic == ROM_LIBRARY_MAGIC;
+}
+
+/*
+ * simple checksum of a rom image
+ */
+static uint32_t checksum(const uint8_t* data, size_t size)
+{
+  uint32_t sum = 5381;
+  for (size_t i = 0; i < size; ++i)
+  {
+    sum = ((sum << 5) + sum) + data[i];
+  }
+  return sum;
+}
+
+/*
+ * copy the index from flash for modification
+ */
+static RomLibraryIndex* editIndex()
+{
+  RomLibraryIndex* index = (RomLibraryIndex*)indexBuffer;
+  memset(indexBuffer, 0xff, sizeof(indexBuffer));
+
+  if (indexValid())
+  {
+    memcpy(index, flashIndex(), sizeof(RomLibraryIndex));
+
+    // fold in the last used log (the commit clears it)
+    const uint8_t* log = flashLog();
+    for (int i = 0, count = logCount(); i < count; ++i)
+    {
+      if (log[i] < ROM_LIBRARY_SLOTS && index->entries[log[i]].lastUsed)
+      {
+        index->entries[log[i]].lastUsed = ++index->sequence;
+      }
+    }
+  }
+  else
+  {
+    memset(index, 0, sizeof(RomLibraryIndex));
+    index->magic = ROM_LIBRARY_MAGIC;
+  }
+  return index;
+}
+
+/*
+ * write the modified index back to flash
+ */
+static void commitIndex()
+{
+  flashStoreWrite(ROM_LIBRARY_OFFSET, ROM_LIBRARY_INDEX_SIZE, indexBuffer, sizeof(indexBuffer));
+}
+
+/*
+ * append to the last used log (no erase). false if it's full
+ */
+static bool logLastUsed(int slot)
+{
+  int count = logCount();
+  if (count >= ROM_LIBRARY_LOG_SIZE) return false;
+
+  // the rest of the page is left erased, so the existing entries are unchanged
+  uint32_t pos = ROM_LIBRARY_LOG_OFFSET + count;
+  uint8_t __aligned(4) page[FLASH_PAGE_SIZE];
+  memset(page, ROM_LIBRARY_LOG_EMPTY, sizeof(page));
+  page[pos % FLASH_PAGE_SIZE] = slot;
+
+  flashStoreProgram(ROM_LIBRARY_OFFSET + pos - (pos % FLASH_PAGE_SIZE), page, sizeof(page));
+  return true;
+}
+
+/*
+ * mark a slot as last used. appends to the log, only rewriting the index
+ * when the log is full
+ */
+static void markLastUsed(int slot)
+{
+  if (slot == romLibraryLastUsed()) return;
+
+  if (!logLastUsed(slot))
+  {
+    RomLibraryIndex* index = editIndex();
+    index->entries[slot].lastUsed = ++index->sequence;
+    commitIndex();
+  }
+}
+
+/*
+ * the slot of a stored rom (by name), or -1
+ */
+int romLibraryFind(const char* name)
+{
+  for (int slot = 0; slot < ROM_LIBRARY_SLOTS; ++slot)
+  {
+    const RomLibraryEntry* entry = romLibraryEntry(slot);
+    if (entry && strncmp(entry->name, name, ROM_LIBRARY_NAME_LEN) == 0)
+    {
+      return slot;
+    }
+  }
+  return -1;
+}
+
+/*
+ * the stored rom in a slot (NULL if empty)
+ */
+const RomLibraryEntry* romLibraryEntry(int slot)
+{
+  if (!indexValid() || slot < 0 || slot >= ROM_LIBRARY_SLOTS) return NULL;
+
+  const RomLibraryEntry* entry = &flashIndex()->entries[slot];
+  return entry->lastUsed ? entry : NULL;
+}
+
+/*
+ * the most recently used slot, or -1
+ */
+int romLibraryLastUsed()
+{
+  if (!indexValid()) return -1;
+
+  int count = logCount();
+  if (count && romLibraryEntry(flashLog()[count - 1]))
+  {
+    return flashLog()[count - 1];
+  }
+
+  for (int slot = 0; slot < ROM_LIBRARY_SLOTS; ++slot)
+  {
+    const RomLibraryEntry* entry = romLibraryEntry(slot);
+    if (entry && entry->lastUsed == flashIndex()->sequence)
+    {
+      return slot;
+    }
+  }
+  return -1;
+}
+
+/*
+ * copy a stored rom into the rom image and mark it as last used
+ */
+bool romLibraryLoad(int slot, uint8_t* rom, size_t romSize)
+{
+  const RomLibraryEntry* entry = romLibraryEntry(slot);
+  if (!entry || entry->size > romSize) return false;
+
+  const uint8_t* src = flashSlot(slot);
+  if (checksum(src, entry->size) != entry->checksum) return false;
+
+  memcpy(rom, src, entry->size);
+
+  markLastUsed(slot);
+  return true;
+}
+
+/*
+ * store a rom image and mark it as last used. returns the slot or -1
+ */
+int romLibraryStore(const char* name, const uint8_t* rom, size_t romSize)
+{
+  if (romSize > ROM_LIBRARY_SLOT_SIZE) return -1;
+
+  uint32_t romChecksum = checksum(rom, romSize);
+
+  // replace the same rom, else use an empty slot, else the least recently used
+  int slot = romLibraryFind(name);
+  bool sameName = slot >= 0;
+  if (!sameName)
+  {
+    uint32_t oldest = UINT32_MAX;
+    for (int i = 0; i < ROM_LIBRARY_SLOTS; ++i)
+    {
+      const RomLibraryEntry* entry = romLibraryEntry(i);
+      uint32_t lastUsed = entry ? entry->lastUsed : 0;
+      if (lastUsed < oldest)
+      {
+        oldest = lastUsed;
+        slot = i;
+      }
+    }
+  }
+
+  // already stored? then only the last used log changes (no erase)
+  const RomLibraryEntry* existing = romLibraryEntry(slot);
+  if (sameName && existing->size == romSize && existing->checksum == romChecksum)
+  {
+    markLastUsed(slot);
+    return slot;
+  }
+
+  uint32_t offset = ROM_LIBRARY_OFFSET + ROM_LIBRARY_INDEX_SIZE + slot * ROM_LIBRARY_SLOT_SIZE;
+  flashStoreWrite(offset, ROM_LIBRARY_SLOT_SIZE, rom, romSize);
+
+  RomLibraryIndex* index = editIndex();
+  RomLibraryEntry* entry = &index->entries[slot];
+  strncpy(entry->name, name, ROM_LIBRARY_NAME_LEN - 1);
+  entry->name[ROM_LIBRARY_NAME_LEN - 1] = '\0';
+  entry->size = romSize;
+  entry->checksum = romChecksum;
+  entry->lastUsed = ++index->sequence;
+  commitIndex();
+
+  return slot;
+}
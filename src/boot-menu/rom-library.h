@@ -0,0 +1,54 @@
+/*
+ * Project: pico-56 - boot menu rom library
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ROM_LIBRARY_SLOTS      8
+#define ROM_LIBRARY_SLOT_SIZE  (32 * 1024)
+#define ROM_LIBRARY_NAME_LEN   48
+
+typedef struct
+{
+  char name[ROM_LIBRARY_NAME_LEN];
+  uint32_t size;
+  uint32_t checksum;
+  uint32_t lastUsed;      // sequence number. 0 = empty slot
+} RomLibraryEntry;
+
+/*
+ * the slot of a stored rom (by name), or -1
+ */
+int romLibraryFind(const char* name);
+
+/*
+ * the stored rom in a slot (NULL if empty)
+ */
+const RomLibraryEntry* romLibraryEntry(int slot);
+
+/*
+ * the most recently used slot, or -1
+ */
+int romLibraryLastUsed();
+
+/*
+ * copy a stored rom into the rom image and mark it as last used
+ */
+bool romLibraryLoad(int slot, uint8_t* rom, size_t romSize);
+
+/*
+ * store a rom image (replacing the least recently used if full) and
+ * mark it as last used. returns the slot or -1
+ */
+int romLibraryStore(const char* name, const uint8_t* rom, size_t romSize);
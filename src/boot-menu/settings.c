@@ -0,0 +1,122 @@
+/*
+ * Project: pico-56 - boot menu settings
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "settings.h"
+#include "flash-store.h"
+
+#include "pico/stdlib.h"
+
+#include <string.h>
+
+#define SETTINGS_MAGIC  0x53363550  /* "P56S" */
+
+typedef struct
+{
+  uint32_t magic;
+  Settings settings;
+} StoredSettings;
+
+typedef struct
+{
+  VgaMode mode;
+  uint32_t pixelScale;
+  const char* name;
+} VgaModeOption;
+
+/*
+ * supported display modes. each gives at least 256x192 virtual pixels
+ */
+static const VgaModeOption vgaModes[] = {
+  { VGA_800_600_60HZ,   3, "800x600 /3" },    // default. 266x200
+  { VGA_640_480_60HZ,   2, "640x480 /2" },    // 320x240
+  { VGA_640_400_70HZ,   2, "640x400 /2" },    // 320x200
+  { VGA_800_600_60HZ,   2, "800x600 /2" },    // 400x300
+  { VGA_1024_768_60HZ,  4, "1024x768 /4" },   // 256x192
+  { VGA_1024_768_60HZ,  3, "1024x768 /3" },   // 341x256
+  { VGA_1280_1024_60HZ, 4, "1280x1024 /4" },  // 320x256
+};
+
+static uint8_t __aligned(4) settingsBuffer[FLASH_PAGE_SIZE];
+
+/*
+ * the stored settings in flash
+ */
+static inline const StoredSettings* flashSettings()
+{
+  return (const StoredSettings*)(XIP_BASE + FLASH_STORE_SETTINGS_OFFSET);
+}
+
+/*
+ * index of a display mode in vgaModes (or -1)
+ */
+static int vgaModeIndex(const Settings* settings)
+{
+  for (int i = 0; i < count_of(vgaModes); ++i)
+  {
+    if (vgaModes[i].mode == settings->vgaMode && vgaModes[i].pixelScale == settings->pixelScale)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/*
+ * the persisted settings (or defaults)
+ */
+const Settings* settingsCurrent()
+{
+  static Settings current;
+
+  current.vgaMode = vgaModes[0].mode;
+  current.pixelScale = vgaModes[0].pixelScale;
+
+  const StoredSettings* stored = flashSettings();
+  if (stored->magic == SETTINGS_MAGIC && vgaModeIndex(&stored->settings) >= 0)
+  {
+    current = stored->settings;
+  }
+
+  return &current;
+}
+
+/*
+ * persist settings (they take effect at the next boot)
+ */
+void settingsSave(const Settings* settings)
+{
+  memset(settingsBuffer, 0xff, sizeof(settingsBuffer));
+
+  StoredSettings* stored = (StoredSettings*)settingsBuffer;
+  stored->magic = SETTINGS_MAGIC;
+  stored->settings = *settings;
+
+  flashStoreWrite(FLASH_STORE_SETTINGS_OFFSET, FLASH_STORE_SETTINGS_SIZE, settingsBuffer, sizeof(settingsBuffer));
+}
+
+/*
+ * select the next supported display mode
+ */
+void settingsNextVgaMode(Settings* settings)
+{
+  int index = (vgaModeIndex(settings) + 1) % count_of(vgaModes);
+  settings->vgaMode = vgaModes[index].mode;
+  settings->pixelScale = vgaModes[index].pixelScale;
+}
+
+/*
+ * display mode description (eg. "800x600 /3")
+ */
+const char* settingsVgaModeName(const Settings* settings)
+{
+  int index = vgaModeIndex(settings);
+  return (index < 0) ? "unknown" : vgaModes[index].name;
+}
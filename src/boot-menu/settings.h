@@ -0,0 +1,42 @@
+/*
+ * Project: pico-56 - boot menu settings
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include "vga-modes.h"
+
+#include <inttypes.h>
+
+typedef struct
+{
+  uint32_t vgaMode;       // VgaMode
+  uint32_t pixelScale;
+} Settings;
+
+/*
+ * the persisted settings (or defaults)
+ */
+const Settings* settingsCurrent();
+
+/*
+ * persist settings (they take effect at the next boot)
+ */
+void settingsSave(const Settings* settings);
+
+/*
+ * select the next supported display mode
+ */
+void settingsNextVgaMode(Settings* settings);
+
+/*
+ * display mode description (eg. "800x600 /3")
+ */
+const char* settingsVgaModeName(const Settings* settings);
@@ -1,467 +1,1193 @@
-/*
- * Project: pico-56 - the bus
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-#include "vrEmu6502.h"
-#include "vrEmu6522.h"
-#include "tms9918.h"
-#include "audio.h"
-#include "nes-ctrl.h"
-#include "ps2-kbd.h"
-#include "sdcard.h"
-
-#include "interrupts.h"
-#include "config.h"
-
-#include "bus.h"
-
-#include "pico/stdlib.h"
-#include "pico/time.h"
-
-#include <stdlib.h>
-#include <stdio.h>
-#include <string.h>
-
- // HBC-56 RAM
-static uint8_t __aligned(4) ram[HBC56_RAM_SIZE];
-
-// HBC-56 ROM
-extern uint8_t pico56rom[];
-
-// ROM access
-uint8_t* romPtr()
-{
-  return pico56rom;
-}
-size_t romSize()
-{
-  return HBC56_ROM_SIZE;
-}
-
-static VrEmu6502* cpu = NULL;
-static VrEmu6522* via = NULL;
-static VrEmuTms9918* tms9918 = NULL;
-
-#define HBC56_CLOCK_FREQ_MHZ 3.686400 /* half of 7.3728*/
-#define MICROSECONDS_PER_BURST  50
-#define TICKS_PER_BURST (int)(MICROSECONDS_PER_BURST * HBC56_CLOCK_FREQ_MHZ)
-
-#define FOPEN_PORT 0x04
-#define FCLOSE_PORT 0x04
-#define FREAD_PORT 0x05
-#define FWRITE_PORT 0x05
-
-FIL fil;
-
-char dirListing[2048];
-char* dirListPtr = NULL;
-
-#define CPU_6502_WAI 0xcb
-
-#define UART_STATUS_RX_REG_FULL       0b00000001
-#define UART_STATUS_TX_REG_EMPTY      0b00000010
-
-static uint8_t uartControl = 0;
-static uint8_t uartStatus = UART_STATUS_TX_REG_EMPTY;
-static uint8_t uartBuffer = 0;
-
-
-/*
- * 65c02 bus read/write callbacks
- */
-void busWrite(uint16_t addr, uint8_t val);
-uint8_t busRead(uint16_t addr, bool isDbg);
-
-static bool capsOn = false;   // 4
-static bool numOn = false;    // 2
-static bool scrollOn = false; // 1
-
-/*
- * called at the end of each frame
- */
-static void endOfFrameCb(uint64_t frameNumber)
-{
-  static uint8_t lastCode = 0;
-
-  static uint8_t writeQueue[2] = { 0, 0 };
-  static uint8_t writeQueueSize = 0;
-
-  if (writeQueueSize)
-  {
-    ps2kbd_write(writeQueue[--writeQueueSize]);
-    writeQueue[writeQueueSize] = 0;
-  }
-  else
-  {
-    // update keyboard state
-    uint8_t kbdScancode = ps2kbd_read();
-    if (kbdScancode != 0)
-    {
-      kbdQueuePush(kbdScancode);
-
-      if (lastCode != 0xf0)
-      {
-        if (kbdScancode == 0x58 ||  // caps
-          kbdScancode == 0x7e ||  // scroll
-          kbdScancode == 0x77)  // num
-        {
-          if (kbdScancode == 0x58) capsOn = !capsOn;
-          if (kbdScancode == 0x7e) scrollOn = !scrollOn;
-          if (kbdScancode == 0x77) numOn = !numOn;
-          writeQueue[0] = (capsOn ? 0x04 : 0x00) | (scrollOn ? 0x01 : 0x00) | (numOn ? 0x02 : 0x00);
-          writeQueue[1] = 0xed;
-          writeQueueSize = 2;
-        }
-      }
-      lastCode = kbdScancode;
-    }
-  }
-
-  // update nes state
-  nes_read_finish();
-  nes_read_start();
-}
-
-/*
- * initialize the bus / hardware / devices
-*/
-void busInit()
-{
-  // 65C02 cpu
-  cpu = vrEmu6502New(CPU_W65C02, busRead, busWrite);
-
-  // 65C22 VIA
-  via = vrEmu6522New(VIA_65C22);
-
-  // TMS9918A VDP
-  tms9918 = tmsInit();
-  tmsSetFrameCallback(endOfFrameCb);
-
-  // Dual AY-3-8910 PSGs
-  audioInit(HBC56_AY38910_CLOCK, tmsGetHsyncFreq());
-  tmsSetHsyncCallback(audioUpdate);
-
-  // PS/2 keyboard
-  ps2kbd_begin();
-
-  // dual NES controllers
-  nes_begin();
-  nes_read_start();
-}
-
-/*
- * the main loop
- */
-void __not_in_flash_func(busMainLoop)()
-{
-  /* reset the cpu (technically don't need to do this as vrEmu6502New does reset it) */
-  vrEmu6502Reset(cpu);
-
-  capsOn = numOn = scrollOn = false;
-
-  // revert keyboard 'locks'
-  ps2kbd_write(0xed);
-  sleep_ms(10);
-  ps2kbd_write(0x00);
-
-  absolute_time_t startTime = get_absolute_time();
-  absolute_time_t currentTime = startTime;
-  absolute_time_t nextUartTime = startTime;
-
-  int i = 0;
-  int prevViaInt = IntCleared;
-
-  // loop forever
-  while (1)
-  {
-    // run the cpu for a number of ticks
-    while (i < TICKS_PER_BURST)
-    {
-      int cycleTicks = vrEmu6502InstCycle(cpu);
-      if (vrEmu6502GetCurrentOpcode(cpu) == CPU_6502_WAI)
-      {
-        i += TICKS_PER_BURST;
-        break;
-      }
-      i += cycleTicks;
-    }
-    i -= TICKS_PER_BURST;
-
-    // run the via for a number of ticks
-    vrEmu6522Ticks(via, TICKS_PER_BURST);
-
-    if (uartBuffer == 0)
-    {
-      nextUartTime = delayed_by_us(currentTime, 100);
-      int c = getchar_timeout_us(0);
-      if (c != PICO_ERROR_TIMEOUT)
-      {
-        //        putchar(c);
-        uartBuffer = c;// & 0xff;
-        raiseInterrupt(HBC56_UART_IRQ);
-        uartStatus = UART_STATUS_TX_REG_EMPTY;
-        uartStatus |= UART_STATUS_RX_REG_FULL;
-      }
-      else
-      {
-        releaseInterrupt(HBC56_UART_IRQ);
-        uartStatus &= ~(UART_STATUS_RX_REG_FULL);
-      }
-    }
-
-
-    // has the via interrupted?
-    setOrClearInterrupt(HBC56_VIA_IRQ, *vrEmu6522Int(via) == IntRequested);
-
-    // set cpu interrupt
-    *(vrEmu6502Int(cpu)) = intReg() ? IntRequested : IntCleared;
-
-    // delay or continue immediately to keep cpu clock
-    currentTime = delayed_by_us(currentTime, MICROSECONDS_PER_BURST);
-    if (to_us_since_boot(currentTime) < to_us_since_boot(get_absolute_time()))
-    {
-      currentTime = get_absolute_time();
-    }
-    else
-    {
-      busy_wait_until(currentTime);
-    }
-  }
-}
-
-
-/*
- * 65c02 write to the bus
- */
-void __not_in_flash_func(busWrite)(uint16_t addr, uint8_t val)
-{
-  // ram?
-  if (addr < HBC56_IO_START)
-  {
-    ram[addr] = val;
-  }
-
-  // io?
-  else if (addr <= HBC56_ROM_START)
-  {
-    if ((addr & HBC56_VIA_PORT) == HBC56_VIA_PORT)
-    {
-      vrEmu6522Write(via, addr & 0x0f, val);
-      setOrClearInterrupt(HBC56_VIA_IRQ, *vrEmu6522Int(via) == IntRequested);
-    }
-    else
-    {
-      switch (addr & 0xff)
-      {
-        case HBC56_TMS9918_PORT:
-          vrEmuTms9918WriteData(tms9918, val);
-          break;
-
-        case HBC56_TMS9918_PORT | 0x01:
-          vrEmuTms9918WriteAddr(tms9918, val);
-          break;
-
-        case HBC56_AY38910_A_PORT:
-        case HBC56_AY38910_A_PORT | 0x01:
-          audioWritePsg0(addr, val);
-          break;
-
-        case HBC56_AY38910_B_PORT:
-        case HBC56_AY38910_B_PORT | 0x01:
-          audioWritePsg1(addr, val);
-          break;
-
-        case HBC56_UART_PORT:
-          uartControl = val;
-          if ((val & 0x03) == 0x03)   // reset
-          {
-            uartStatus = UART_STATUS_TX_REG_EMPTY;
-          }
-          else
-          {
-            releaseInterrupt(HBC56_UART_IRQ);
-          }
-          break;
-
-        case HBC56_UART_PORT | 0x01:
-          putchar(val);
-          break;
-
-        case FOPEN_PORT:
-          {
-            uint16_t addr = ram[val] | (ram[val + 1] << 8);
-            char* strAddr = ram + addr;
-            if (*strAddr == '$')
-            {
-              DIR d;
-              FILINFO fno;
-              memset(&d, 0, sizeof d);
-              memset(&fno, 0, sizeof fno);
-
-              int index = 0;
-              FRESULT fr = f_findfirst(&d, &fno, ".", "*.bas");
-              dirListPtr = dirListing;
-
-              while ((FR_OK == fr) && fno.fname[0] && (dirListPtr < (dirListing + sizeof(dirListing) - 32)))
-              {
-                dirListPtr += sprintf(dirListPtr, "%d %-18.18s %7d B\r", index, fno.fname, fno.fsize);
-
-                index++;
-                fr = f_findnext(&d, &fno);
-              }
-              dirListPtr = dirListing;
-            }
-            else
-            {
-              dirListPtr = NULL;
-              f_open(&fil, strAddr, FA_OPEN_ALWAYS | FA_WRITE | FA_READ);
-            }
-          }
-          break;
-
-        case FWRITE_PORT:
-          {
-            uint bw = 0;
-            f_write(&fil, &val, 1, &bw);
-          }
-          break;
-
-        default:
-          // unknown device
-          break;
-      }
-    }
-  }
-}
-
-#define KB_INT_FLAG 0x02
-#define KB_RDY_FLAG 0x04
-
-/*
- * 65c02 read from the bus
- */
-uint8_t __not_in_flash_func(busRead)(uint16_t addr, bool isDbg)
-{
-  // rom?
-  if (addr & 0x8000)
-  {
-    return pico56rom[addr & (HBC56_ROM_SIZE - 1)];
-  }
-
-  // ram?
-  else if (addr < HBC56_IO_START)
-  {
-    return ram[addr];
-  }
-
-  // io?
-  else
-  {
-    if ((addr & HBC56_VIA_PORT) == HBC56_VIA_PORT)
-    {
-      uint8_t value = vrEmu6522Read(via, addr & 0x0f);
-      setOrClearInterrupt(HBC56_VIA_IRQ, *vrEmu6522Int(via) == IntRequested);
-      return value;
-    }
-    else
-    {
-      switch (addr & 0xff)
-      {
-        case HBC56_TMS9918_PORT:
-          {
-            return vrEmuTms9918ReadData(tms9918);
-          }
-
-        case HBC56_TMS9918_PORT | 0x01:
-          {
-            uint8_t value = vrEmuTms9918ReadStatus(tms9918);
-            releaseInterrupt(HBC56_TMS9918_IRQ);
-            return value;
-          }
-
-        case HBC56_KB_PORT:
-          {
-            uint8_t value = 0;
-            if (!kbdQueueEmpty())
-            {
-              value = kbdQueuePop();
-            }
-            return value;
-          }
-        case HBC56_KB_PORT | 0x01:
-          {
-            return (!kbdQueueEmpty())
-              ? (KB_INT_FLAG | KB_RDY_FLAG)
-              : 0;
-          }
-        case HBC56_NES_PORT:
-          return nes_get_state_1();
-
-        case HBC56_NES_PORT | 0x01:
-          return nes_get_state_2();
-
-        case HBC56_IRQ_PORT:
-          return intReg();
-
-        case HBC56_AY38910_A_PORT | 0x02:
-          return audioReadPsg0();
-
-        case HBC56_AY38910_B_PORT | 0x02:
-          return audioReadPsg1();
-
-        case HBC56_UART_PORT:
-          return uartStatus;
-
-        case HBC56_UART_PORT | 0x01:
-          {
-            int c = getchar_timeout_us(0);
-            if (c == PICO_ERROR_TIMEOUT)
-            {
-              releaseInterrupt(HBC56_UART_IRQ);
-              uartStatus &= ~(UART_STATUS_RX_REG_FULL);
-              c = 0;
-            }
-            uint8_t val = uartBuffer;
-            uartBuffer = c;
-            return val;
-          }
-
-        case FCLOSE_PORT:
-          f_close(&fil);
-          return 0;
-
-        case FREAD_PORT:
-          {
-            uint8_t value = 0;
-            if (dirListPtr)
-            {
-              value = *dirListPtr++;
-              if (value == 0 || (dirListPtr >= (dirListing + sizeof(dirListing))))
-              {
-                dirListPtr = NULL;
-              }
-            }
-            else
-            {
-              uint br = 0;
-              if (f_read(&fil, &value, 1, &br) != FR_OK)
-              {
-                value = 0;
-              }
-            }
-            return value;
-          }
-
-        default:
-          return 0x00;
-      }
-    }
-  }
-}
+/*
+ * Project: pico-56 - the bus
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "vrEmu6502.h"
+#include "vrEmu6522.h"
+#include "tms9918.h"
+#include "vrEmuTms9918Util.h"
+#include "audio.h"
+#include "nes-ctrl.h"
+#include "ps2-kbd.h"
+#include "sdcard.h"
+
+#include "interrupts.h"
+#include "hud.h"
+#include "config.h"
+
+#include "bus.h"
+#include "rewind.h"
+#include "replay.h"
+#include "governor.h"
+
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "hardware/clocks.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+ // HBC-56 RAM
+static uint8_t __aligned(4) ram[HBC56_RAM_SIZE];
+
+// HBC-56 ROM
+extern uint8_t pico56rom[];
+
+// ROM access
+uint8_t* romPtr()
+{
+  return pico56rom;
+}
+size_t romSize()
+{
+  return HBC56_ROM_SIZE;
+}
+
+static VrEmu6502* cpu = NULL;
+static VrEmu6522* via = NULL;
+static VrEmuTms9918* tms9918 = NULL;
+
+#define HBC56_CLOCK_FREQ_MHZ 3.686400 /* half of 7.3728*/
+#define MICROSECONDS_PER_BURST  50
+#define TICKS_PER_BURST (int)(MICROSECONDS_PER_BURST * HBC56_CLOCK_FREQ_MHZ)
+
+#define FOPEN_PORT 0x04
+#define FCLOSE_PORT 0x04
+#define FREAD_PORT 0x05
+#define FWRITE_PORT 0x05
+
+FIL fil;
+
+char dirListing[2048];
+char* dirListPtr = NULL;
+
+#define CPU_6502_WAI 0xcb
+
+#define UART_STATUS_RX_REG_FULL       0b00000001
+#define UART_STATUS_TX_REG_EMPTY      0b00000010
+
+static uint8_t uartControl = 0;
+static uint8_t uartStatus = UART_STATUS_TX_REG_EMPTY;
+static uint8_t uartBuffer = 0;
+
+// emulated cpu time. inputs are applied against this rather than wall-clock
+// time so a recorded session can be replayed exactly
+static uint64_t burstCycle = 0;   // cycle at the start of the current burst
+static int burstTicks = 0;        // cycles into the current burst
+
+// emulated vdp beam position. vdp register writes are tagged with it so the
+// renderer can apply them on the right line. the frame is anchored to the
+// vdp interrupt (the first line after the display)
+static uint32_t vdpCyclesPerFrame = 0;
+static uint64_t vdpFrameCycle = 0;
+static uint32_t vdpVblankCount = 0;
+
+static uint8_t nesState1 = 0xff;
+static uint8_t nesState2 = 0xff;
+
+#define INPUT_QUEUE_SIZE 64   // power of 2
+
+// inputs from core1 (keyboard, nes) waiting to be applied by core0
+static volatile uint16_t inputQueue[INPUT_QUEUE_SIZE];
+static volatile uint32_t inputQueueHead = 0;  // written by core1
+static volatile uint32_t inputQueueTail = 0;  // written by core0
+static volatile bool cpuRunning = false;      // until then, input goes straight to the boot menu
+
+#if HBC56_HAVE_REPLAY
+
+// when recording or replaying, the vdp interrupt is raised from emulated
+// time too (otherwise it lands on a different instruction each run)
+static bool deterministic = false;
+static uint32_t cyclesPerFrame = 0;
+static uint64_t nextFrameCycle = 0;
+static uint64_t nextFlushCycle = 0;
+static bool vdpIntFlag = false;
+static uint8_t vdpSpriteStatus = 0;   // collision and fifth sprite flags latched at each frame
+
+#endif
+
+/*
+ * 65c02 bus read/write callbacks
+ */
+void busWrite(uint16_t addr, uint8_t val);
+uint8_t busRead(uint16_t addr, bool isDbg);
+
+static bool capsOn = false;   // 4
+static bool numOn = false;    // 2
+static bool scrollOn = false; // 1
+
+/*
+ * current emulated cpu cycle
+ */
+static inline uint64_t currentCycle()
+{
+  return burstCycle + burstTicks;
+}
+
+/*
+ * emulated vdp scanline (0 is the first display line)
+ */
+static inline uint16_t vdpScanline()
+{
+  if (!vdpCyclesPerFrame) return TMS_LINE_NONE;
+
+  uint64_t lines = (currentCycle() - vdpFrameCycle) * TMS_LINES_PER_FRAME / vdpCyclesPerFrame;
+  return (TMS9918_PIXELS_Y + lines) % TMS_LINES_PER_FRAME;
+}
+
+/*
+ * queue an input for core0 (called from core1)
+ */
+static void inputQueuePush(ReplayInput type, uint8_t value)
+{
+  uint32_t head = inputQueueHead;
+  if (head - inputQueueTail >= INPUT_QUEUE_SIZE) return;  // full. drop it
+
+  inputQueue[head & (INPUT_QUEUE_SIZE - 1)] = (type << 8) | value;
+  __dmb();
+  inputQueueHead = head + 1;
+}
+
+/*
+ * apply an input to the emulated devices
+ */
+static void applyInput(ReplayInput type, uint8_t value)
+{
+  switch (type)
+  {
+    case REPLAY_INPUT_KBD:
+      kbdQueuePush(value);
+      break;
+
+    case REPLAY_INPUT_NES1:
+      nesState1 = value;
+      break;
+
+    case REPLAY_INPUT_NES2:
+      nesState2 = value;
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*
+ * apply queued inputs (called from core0 between bursts)
+ */
+static void processInputs()
+{
+  uint64_t cycle = currentCycle();
+
+  while (inputQueueTail != inputQueueHead)
+  {
+    __dmb();
+    uint16_t input = inputQueue[inputQueueTail & (INPUT_QUEUE_SIZE - 1)];
+    ++inputQueueTail;
+
+#if HBC56_HAVE_REPLAY
+    // live input is ignored during playback
+    if (replayMode() == REPLAY_PLAYBACK) continue;
+
+    replayRecord(cycle, input >> 8, input & 0xff);
+#endif
+
+    applyInput(input >> 8, input & 0xff);
+  }
+
+#if HBC56_HAVE_REPLAY
+  ReplayEvent event;
+  while (replayNext(cycle, REPLAY_INPUT_MASK(REPLAY_INPUT_KBD) | REPLAY_INPUT_MASK(REPLAY_INPUT_NES1) | REPLAY_INPUT_MASK(REPLAY_INPUT_NES2), &event))
+  {
+    applyInput(event.type, event.value);
+  }
+#endif
+}
+
+/*
+ * read a byte from the uart (or the replay log)
+ */
+static int uartReadInput()
+{
+#if HBC56_HAVE_REPLAY
+  switch (replayMode())
+  {
+    case REPLAY_PLAYBACK:
+      {
+        ReplayEvent event;
+        return replayNext(currentCycle(), REPLAY_INPUT_MASK(REPLAY_INPUT_UART), &event)
+          ? event.value
+          : PICO_ERROR_TIMEOUT;
+      }
+
+    case REPLAY_RECORD:
+      {
+        int c = getchar_timeout_us(0);
+        if (c != PICO_ERROR_TIMEOUT)
+        {
+          replayRecord(currentCycle(), REPLAY_INPUT_UART, c);
+        }
+        return c;
+      }
+
+    default:
+      break;
+  }
+#endif
+
+  return getchar_timeout_us(0);
+}
+
+#if HBC56_HAVE_REWIND
+
+ /*
+  * the rewind state, in order:
+  *
+  *   ram | cpu | vdp registers | vdp port | psg registers | vram | via
+  *
+  * ram and vram are written in pages. pages that haven't been written since
+  * the last snapshot are skipped (they already match the rewind buffer's
+  * reference). the via is saved through its registers (see viaSaveState)
+  */
+
+#define REWIND_PAGE_BYTES   TMS_VRAM_PAGE_BYTES
+#define REWIND_RAM_PAGES    ((HBC56_RAM_SIZE + REWIND_PAGE_BYTES - 1) / REWIND_PAGE_BYTES)
+#define REWIND_CPU_WORDS    2
+#define REWIND_TMS_WORDS    (TMS_NUM_REGISTERS / sizeof(uint32_t))
+#define REWIND_PORT_WORDS   1
+#define REWIND_AUDIO_WORDS  ((AUDIO_STATE_BYTES + sizeof(uint32_t) - 1) / sizeof(uint32_t))
+#define REWIND_REG_WORDS    (REWIND_CPU_WORDS + REWIND_TMS_WORDS + REWIND_PORT_WORDS + REWIND_AUDIO_WORDS)
+#define REWIND_VRAM_WORDS   (TMS9918_VRAM_SIZE / sizeof(uint32_t))
+#define REWIND_VIA_WORDS    5
+
+// via registers
+#define VIA_REG_ORB         0
+#define VIA_REG_ORA         1
+#define VIA_REG_DDRB        2
+#define VIA_REG_DDRA        3
+#define VIA_REG_T1CL        4
+#define VIA_REG_T1CH        5
+#define VIA_REG_T1LL        6
+#define VIA_REG_T1LH        7
+#define VIA_REG_T2CL        8
+#define VIA_REG_T2CH        9
+#define VIA_REG_SR          10
+#define VIA_REG_ACR         11
+#define VIA_REG_PCR         12
+#define VIA_REG_IFR         13
+#define VIA_REG_IER         14
+#define VIA_REG_ORA_NH      15
+#define VIA_REG_COUNT       16
+
+#define VIA_IFR_T2          0x20
+#define VIA_IFR_T1          0x40
+#define VIA_ACR_T1_FREE_RUN 0x40
+
+// saved via state. indexed by register, plus two that can't be read back
+#define VIA_STATE_T2LL      VIA_REG_ORA_NH  // t2 latch (write only)
+#define VIA_STATE_ARMED     VIA_REG_COUNT   // VIA_IFR_T1/VIA_IFR_T2: timer counting to an interrupt
+
+static bool rewindEnabled = false;
+static volatile bool rewindFramePending = false;  // set by core1 at the end of each frame
+static volatile bool rewindKeyHeld = false;
+
+// via registers that read back differently than written (ports, t2 latch)
+// and the timers that are still counting to an interrupt. set by busWrite
+static uint8_t viaWritten[VIA_REG_COUNT];
+static uint8_t viaTimersArmed = 0;
+
+// ram pages written since the last snapshot (set by busWrite)
+static uint32_t ramWrittenPages[(REWIND_RAM_PAGES + 31) / 32];
+
+/*
+ * write pages of data to the rewind buffer, skipping unwritten pages (and
+ * clearing the written flags)
+ */
+static void __not_in_flash_func(rewindWritePages)(const uint8_t* data, size_t bytes, uint32_t* written)
+{
+  size_t pages = (bytes + REWIND_PAGE_BYTES - 1) / REWIND_PAGE_BYTES;
+  for (size_t page = 0; page < pages; ++page)
+  {
+    size_t offset = page * REWIND_PAGE_BYTES;
+    size_t words = ((bytes - offset) < REWIND_PAGE_BYTES ? (bytes - offset) : REWIND_PAGE_BYTES) / sizeof(uint32_t);
+
+    if (written[page / 32] & (1u << (page & 31)))
+    {
+      rewindWrite((const uint32_t*)(data + offset), words);
+    }
+    else
+    {
+      rewindSkip(words);
+    }
+  }
+  memset(written, 0, ((pages + 31) / 32) * sizeof(uint32_t));
+}
+
+/*
+ * a one-shot timer stops interrupting once it has fired
+ *  - run after each via burst, before the cpu can service (clear) the flag
+ */
+static inline void viaTrackTimers()
+{
+  if (!viaTimersArmed) return;
+
+  uint8_t ifr = vrEmu6522Read(via, VIA_REG_IFR);
+  if (!(vrEmu6522Read(via, VIA_REG_ACR) & VIA_ACR_T1_FREE_RUN))
+  {
+    viaTimersArmed &= ~(ifr & VIA_IFR_T1);
+  }
+  viaTimersArmed &= ~(ifr & VIA_IFR_T2);
+}
+
+/*
+ * save the via state. only registers that read back without side effects
+ * are read. the counter low bytes clear the timer flags, so are only read
+ * when the flag is already clear (otherwise the latch stands in). the
+ * handshake (ca/cb) and shift flags can't be recreated, so aren't kept
+ */
+static void __not_in_flash_func(viaSaveState)(uint8_t* state)
+{
+  static const uint8_t readable[] = {
+    VIA_REG_DDRB, VIA_REG_DDRA, VIA_REG_T1CH, VIA_REG_T1LL, VIA_REG_T1LH,
+    VIA_REG_T2CH, VIA_REG_SR, VIA_REG_ACR, VIA_REG_PCR, VIA_REG_IFR, VIA_REG_IER
+  };
+  for (int i = 0; i < count_of(readable); ++i)
+  {
+    state[readable[i]] = vrEmu6522Read(via, readable[i]);
+  }
+
+  uint8_t ifr = state[VIA_REG_IFR];
+  state[VIA_REG_T1CL] = (ifr & VIA_IFR_T1) ? state[VIA_REG_T1LL] : vrEmu6522Read(via, VIA_REG_T1CL);
+  state[VIA_REG_T2CL] = (ifr & VIA_IFR_T2) ? viaWritten[VIA_REG_T2CL] : vrEmu6522Read(via, VIA_REG_T2CL);
+
+  state[VIA_REG_ORB] = viaWritten[VIA_REG_ORB];
+  state[VIA_REG_ORA] = viaWritten[VIA_REG_ORA];
+  state[VIA_STATE_T2LL] = viaWritten[VIA_REG_T2CL];
+  state[VIA_STATE_ARMED] = viaTimersArmed;
+}
+
+/*
+ * restore the via state. a pending timer flag is recreated by loading that
+ * counter with zero, so it fires on the next via tick
+ */
+static void viaRestoreState(const uint8_t* state)
+{
+  vrEmu6522Write(via, VIA_REG_IER, 0x7f);
+  vrEmu6522Write(via, VIA_REG_IFR, 0x7f);
+
+  vrEmu6522Write(via, VIA_REG_DDRB, state[VIA_REG_DDRB]);
+  vrEmu6522Write(via, VIA_REG_DDRA, state[VIA_REG_DDRA]);
+  vrEmu6522Write(via, VIA_REG_ORB, state[VIA_REG_ORB]);
+  vrEmu6522Write(via, VIA_REG_ORA_NH, state[VIA_REG_ORA]);
+  vrEmu6522Write(via, VIA_REG_ACR, state[VIA_REG_ACR]);
+  vrEmu6522Write(via, VIA_REG_PCR, state[VIA_REG_PCR]);
+  vrEmu6522Write(via, VIA_REG_SR, state[VIA_REG_SR]);
+
+  // timer 1. loading the counter also loads the latch, so the latch is last
+  uint8_t ifr = state[VIA_REG_IFR];
+  uint8_t armed = state[VIA_STATE_ARMED];
+  if (ifr & VIA_IFR_T1)
+  {
+    vrEmu6522Write(via, VIA_REG_T1CL, 0);
+    vrEmu6522Write(via, VIA_REG_T1CH, 0);
+  }
+  else if (armed & VIA_IFR_T1)
+  {
+    vrEmu6522Write(via, VIA_REG_T1CL, state[VIA_REG_T1CL]);
+    vrEmu6522Write(via, VIA_REG_T1CH, state[VIA_REG_T1CH]);
+  }
+  vrEmu6522Write(via, VIA_REG_T1LL, state[VIA_REG_T1LL]);
+  vrEmu6522Write(via, VIA_REG_T1LH, state[VIA_REG_T1LH]);
+
+  // timer 2. the low latch is written again after any counter load
+  if (ifr & VIA_IFR_T2)
+  {
+    vrEmu6522Write(via, VIA_REG_T2CL, 0);
+    vrEmu6522Write(via, VIA_REG_T2CH, 0);
+  }
+  else if (armed & VIA_IFR_T2)
+  {
+    vrEmu6522Write(via, VIA_REG_T2CL, state[VIA_REG_T2CL]);
+    vrEmu6522Write(via, VIA_REG_T2CH, state[VIA_REG_T2CH]);
+  }
+  vrEmu6522Write(via, VIA_REG_T2CL, state[VIA_STATE_T2LL]);
+
+  vrEmu6522Write(via, VIA_REG_IER, 0x80 | state[VIA_REG_IER]);
+
+  viaWritten[VIA_REG_ORB] = state[VIA_REG_ORB];
+  viaWritten[VIA_REG_ORA] = state[VIA_REG_ORA];
+  viaWritten[VIA_REG_T2CL] = state[VIA_STATE_T2LL];
+  viaTimersArmed = armed | (ifr & (VIA_IFR_T1 | VIA_IFR_T2));
+}
+
+/*
+ * snapshot the machine state to the rewind buffer
+ *  - run on core0 between cpu bursts so the cpu, ram and vram are consistent
+ */
+static void __not_in_flash_func(rewindCaptureFrame)()
+{
+  uint32_t regs[REWIND_REG_WORDS] = { 0 };
+  regs[0] = vrEmu6502GetPC(cpu) | (vrEmu6502GetAcc(cpu) << 16) | (vrEmu6502GetX(cpu) << 24);
+  regs[1] = vrEmu6502GetY(cpu) | (vrEmu6502GetStackPointer(cpu) << 8) | (vrEmu6502GetStatus(cpu) << 16) | (intReg() << 24);
+
+  uint8_t* tmsRegs = (uint8_t*)(regs + REWIND_CPU_WORDS);
+  for (int i = 0; i < TMS_NUM_REGISTERS; ++i)
+  {
+    tmsRegs[i] = vrEmuTms9918RegValue(tms9918, i);
+  }
+  regs[REWIND_CPU_WORDS + REWIND_TMS_WORDS] = tmsPortState();
+  audioSaveState((uint8_t*)(regs + REWIND_CPU_WORDS + REWIND_TMS_WORDS + REWIND_PORT_WORDS));
+
+  rewindBeginFrame();
+  rewindWritePages(ram, HBC56_RAM_SIZE, ramWrittenPages);
+  rewindWrite(regs, count_of(regs));
+  rewindWritePages(tmsVramShadow(), TMS9918_VRAM_SIZE, tmsVramWrittenPages());
+  uint32_t viaState[REWIND_VIA_WORDS] = { 0 };
+  viaSaveState((uint8_t*)viaState);
+  rewindWrite(viaState, count_of(viaState));
+  rewindEndFrame();
+}
+
+/*
+ * step the machine back one frame
+ */
+static void rewindRestoreFrame()
+{
+  if (!rewindStepBack()) return;
+
+  const uint32_t* state = rewindState();
+  memcpy(ram, state, HBC56_RAM_SIZE);
+  state += HBC56_RAM_SIZE / sizeof(uint32_t);
+
+  vrEmu6502SetPC(cpu, state[0] & 0xffff);
+  vrEmu6502SetAcc(cpu, (state[0] >> 16) & 0xff);
+  vrEmu6502SetX(cpu, (state[0] >> 24) & 0xff);
+  vrEmu6502SetY(cpu, state[1] & 0xff);
+  vrEmu6502SetStackPointer(cpu, (state[1] >> 8) & 0xff);
+  vrEmu6502SetStatus(cpu, (state[1] >> 16) & 0xff);
+
+  uint8_t irqs = (state[1] >> 24) & 0xff;
+  for (int irq = 1; irq <= 8; ++irq)
+  {
+    setOrClearInterrupt(irq, irqs & (1 << (irq - 1)));
+  }
+  state += REWIND_CPU_WORDS;
+
+  const uint8_t* tmsRegs = (const uint8_t*)state;
+  tmsSetWriteLine(TMS_LINE_NONE);
+  for (int i = 0; i < TMS_NUM_REGISTERS; ++i)
+  {
+    tmsWriteAddr(tmsRegs[i]);
+    tmsWriteAddr(0x80 | i);
+  }
+  state += REWIND_TMS_WORDS;
+
+  uint32_t portState = *state;
+  state += REWIND_PORT_WORDS;
+
+  audioRestoreState((const uint8_t*)state);
+  state += REWIND_AUDIO_WORDS;
+
+  // only the vram bytes that differ are written. then the address register
+  tmsRestoreVram((const uint8_t*)state);
+  tmsSetPortState(portState);
+  state += REWIND_VRAM_WORDS;
+
+  viaRestoreState((const uint8_t*)state);
+}
+
+#endif
+
+static volatile bool vgaStatsRequested = false;  // set by core1, printed by core0
+
+#if HBC56_HAVE_HUD || HBC56_CLOCK_GOVERNOR
+#define HBC56_MEASURE_CORE0 1
+static uint64_t core0BusyUs = 0;  // core0 time spent emulating (not waiting)
+#endif
+
+#if HBC56_HAVE_HUD
+
+/*
+ * refresh the performance hud text (about once a second while it's visible)
+ */
+static void hudUpdate()
+{
+  static uint64_t lastTime = 0;
+  static uint64_t lastCycle = 0;
+  static uint64_t lastBusyUs = 0;
+  static VgaStats lastStats;
+
+  uint64_t now = time_us_64();
+  if (now - lastTime < 1000000) return;
+
+  VgaStats stats = vgaCurrentStats();
+  uint64_t cycle = currentCycle();
+
+  if (lastTime)
+  {
+    uint32_t elapsedUs = now - lastTime;
+    uint32_t sysClockMHz = clock_get_hz(clk_sys) / 1000000;
+
+    uint32_t cpuKHz = (cycle - lastCycle) * 1000 / elapsedUs;
+    uint32_t core0 = (core0BusyUs - lastBusyUs) * 100 / elapsedUs;
+    uint32_t core1 = (uint64_t)(stats.busyCycles - lastStats.busyCycles) * 100 / ((uint64_t)elapsedUs * sysClockMHz);
+    uint32_t fps = (uint64_t)(stats.frames - lastStats.frames) * 1000000 / elapsedUs;
+
+    // DROP: end of scanline messages core1 missed (each one an audio sample)
+    char text[80];
+    snprintf(text, sizeof(text), "%d.%02d MHZ  C0 %d%%  C1 %d%%  LATE %d  DROP %d  %d FPS",
+      cpuKHz / 1000, (cpuKHz % 1000) / 10, core0, core1,
+      stats.lateLines - lastStats.lateLines,
+      stats.messageOverruns - lastStats.messageOverruns,
+      fps);
+    hudSetText(text, vgaCurrentParams().params.hVirtualPixels);
+  }
+
+  lastTime = now;
+  lastCycle = cycle;
+  lastBusyUs = core0BusyUs;
+  lastStats = stats;
+}
+
+#endif
+
+/*
+ * called at the end of each frame
+ */
+static void endOfFrameCb(uint64_t frameNumber)
+{
+  static uint8_t lastCode = 0;
+
+#if HBC56_HAVE_REWIND
+  rewindFramePending = true;
+#endif
+
+  static uint8_t writeQueue[2] = { 0, 0 };
+  static uint8_t writeQueueSize = 0;
+
+  if (writeQueueSize)
+  {
+    ps2kbd_write(writeQueue[--writeQueueSize]);
+    writeQueue[writeQueueSize] = 0;
+  }
+  else
+  {
+    // update keyboard state
+    uint8_t kbdScancode = ps2kbd_read();
+    if (kbdScancode != 0)
+    {
+      bool forward = true;
+
+#if HBC56_HAVE_REWIND
+      // the rewind key (make and break) isn't passed on. a break prefix is
+      // held back until we know which key it's for
+      static bool breakHeld = false;
+      if (cpuRunning && rewindEnabled)
+      {
+        if (kbdScancode == 0xf0)
+        {
+          breakHeld = true;
+          forward = false;
+        }
+        else
+        {
+          if (kbdScancode == HBC56_REWIND_KEY)
+          {
+            forward = false;
+          }
+          else if (breakHeld)
+          {
+            inputQueuePush(REPLAY_INPUT_KBD, 0xf0);
+          }
+          breakHeld = false;
+        }
+      }
+#endif
+
+      if (forward)
+      {
+        if (cpuRunning)
+        {
+          inputQueuePush(REPLAY_INPUT_KBD, kbdScancode);
+        }
+        else
+        {
+          kbdQueuePush(kbdScancode);
+        }
+      }
+
+      if (lastCode != 0xf0)
+      {
+        if (kbdScancode == 0x58 ||  // caps
+          kbdScancode == 0x7e ||  // scroll
+          kbdScancode == 0x77)  // num
+        {
+          if (kbdScancode == 0x58) capsOn = !capsOn;
+          if (kbdScancode == 0x7e) scrollOn = !scrollOn;
+          if (kbdScancode == 0x77) numOn = !numOn;
+          writeQueue[0] = (capsOn ? 0x04 : 0x00) | (scrollOn ? 0x01 : 0x00) | (numOn ? 0x02 : 0x00);
+          writeQueue[1] = 0xed;
+          writeQueueSize = 2;
+        }
+      }
+
+      if (kbdScancode == HBC56_VGA_STATS_KEY && lastCode != 0xf0)
+      {
+        vgaStatsRequested = true;
+      }
+
+#if HBC56_HAVE_HUD
+      if (kbdScancode == HBC56_HUD_KEY && lastCode != 0xf0)
+      {
+        hudShow(!hudVisible());
+      }
+#endif
+
+#if HBC56_HAVE_REWIND
+      if (kbdScancode == HBC56_REWIND_KEY)
+      {
+        rewindKeyHeld = (lastCode != 0xf0);
+      }
+#endif
+      lastCode = kbdScancode;
+    }
+  }
+
+  // update nes state
+  nes_read_finish();
+  nes_read_start();
+
+  static uint8_t lastNes1 = 0xff;
+  static uint8_t lastNes2 = 0xff;
+
+  if (!cpuRunning) return;
+
+  if (nes_get_state_1() != lastNes1)
+  {
+    lastNes1 = nes_get_state_1();
+    inputQueuePush(REPLAY_INPUT_NES1, lastNes1);
+  }
+  if (nes_get_state_2() != lastNes2)
+  {
+    lastNes2 = nes_get_state_2();
+    inputQueuePush(REPLAY_INPUT_NES2, lastNes2);
+  }
+}
+
+/*
+ * initialize the bus / hardware / devices
+*/
+void busInit()
+{
+  // 65C02 cpu
+  cpu = vrEmu6502New(CPU_W65C02, busRead, busWrite);
+
+  // 65C22 VIA
+  via = vrEmu6522New(VIA_65C22);
+
+  // TMS9918A VDP
+  tms9918 = tmsInit();
+  tmsSetFrameCallback(endOfFrameCb);
+
+  // Dual AY-3-8910 PSGs
+  audioInit(HBC56_AY38910_CLOCK, tmsGetHsyncFreq());
+  tmsSetHsyncCallback(audioUpdate);
+  vdpCyclesPerFrame = HBC56_CLOCK_FREQ / tmsGetVsyncFreq();
+
+  // PS/2 keyboard
+  ps2kbd_begin();
+
+  // dual NES controllers
+  nes_begin();
+  nes_read_start();
+
+#if HBC56_HAVE_REWIND
+  // rewind history (optional - we can run without it)
+  size_t stateWords = (HBC56_RAM_SIZE / sizeof(uint32_t)) + REWIND_REG_WORDS + REWIND_VRAM_WORDS + REWIND_VIA_WORDS;
+  rewindEnabled = rewindInit(stateWords, HBC56_REWIND_BUFFER_SIZE);
+  memset(ramWrittenPages, 0xff, sizeof(ramWrittenPages));
+#endif
+}
+
+/*
+ * the main loop
+ */
+void __not_in_flash_func(busMainLoop)()
+{
+  /* reset the cpu (technically don't need to do this as vrEmu6502New does reset it) */
+  vrEmu6502Reset(cpu);
+
+  capsOn = numOn = scrollOn = false;
+
+  // revert keyboard 'locks'
+  ps2kbd_write(0xed);
+  sleep_ms(10);
+  ps2kbd_write(0x00);
+
+  absolute_time_t startTime = get_absolute_time();
+  absolute_time_t currentTime = startTime;
+  absolute_time_t nextUartTime = startTime;
+
+  int prevViaInt = IntCleared;
+
+  cpuRunning = true;
+
+#if HBC56_TMS9918_DOUBLE_BUFFER
+  // the boot menu is done with the vdp. from here, it's only accessed through the bus
+  tmsEnableDoubleBuffer();
+#endif
+
+#if HBC56_CLOCK_GOVERNOR
+  // the boot menu ran at full speed. from here, only as fast as we need
+  governorInit();
+#endif
+
+#if HBC56_HAVE_REPLAY
+  if (replayMode() != REPLAY_OFF)
+  {
+    deterministic = true;
+    cyclesPerFrame = HBC56_CLOCK_FREQ / tmsGetVsyncFreq();
+    nextFrameCycle = cyclesPerFrame;
+    nextFlushCycle = HBC56_CLOCK_FREQ;
+    tmsSetScanlineInterrupt(false);
+
+#if HBC56_HAVE_REWIND
+    // stepping backwards would desync the log
+    rewindEnabled = false;
+#endif
+  }
+#endif
+
+#if HBC56_HAVE_REWIND
+  // snapshots read vram from the shadow
+  if (rewindEnabled && !tmsEnableShadow())
+  {
+    rewindEnabled = false;
+  }
+#endif
+
+  // loop forever
+  while (1)
+  {
+    bool paused = false;
+
+#if HBC56_MEASURE_CORE0
+    uint64_t burstStartUs = time_us_64();
+#endif
+
+#if HBC56_HAVE_REWIND
+    // once per frame, either snapshot or step backwards (while the key is held)
+    if (rewindEnabled)
+    {
+      paused = rewindKeyHeld;
+      if (rewindFramePending)
+      {
+        rewindFramePending = false;
+        if (paused)
+        {
+          rewindRestoreFrame();
+        }
+        else
+        {
+          rewindCaptureFrame();
+        }
+      }
+    }
+#endif
+
+    if (!paused)
+    {
+      // run the cpu for a number of ticks
+      while (burstTicks < TICKS_PER_BURST)
+      {
+        int cycleTicks = vrEmu6502InstCycle(cpu);
+        if (vrEmu6502GetCurrentOpcode(cpu) == CPU_6502_WAI)
+        {
+          burstTicks += TICKS_PER_BURST;
+          break;
+        }
+        burstTicks += cycleTicks;
+      }
+      burstTicks -= TICKS_PER_BURST;
+      burstCycle += TICKS_PER_BURST;
+
+      // run the via for a number of ticks
+      vrEmu6522Ticks(via, TICKS_PER_BURST);
+#if HBC56_HAVE_REWIND
+      viaTrackTimers();
+#endif
+    }
+
+    processInputs();
+
+    // a new vdp frame? (deterministic frames are anchored below)
+    uint32_t vblanks = tmsVblankCount();
+    if (vblanks != vdpVblankCount)
+    {
+      vdpVblankCount = vblanks;
+#if HBC56_HAVE_REPLAY
+      if (!deterministic)
+#endif
+        vdpFrameCycle = burstCycle;
+    }
+
+    if (vgaStatsRequested)
+    {
+      vgaStatsRequested = false;
+      vgaPrintStats();
+    }
+
+#if HBC56_HAVE_HUD
+    if (hudVisible())
+    {
+      hudUpdate();
+    }
+#endif
+
+#if HBC56_CLOCK_GOVERNOR
+    governorUpdate(core0BusyUs);
+#endif
+
+#if HBC56_HAVE_REPLAY
+    if (deterministic && !paused)
+    {
+      uint64_t cycle = currentCycle();
+      if (cycle >= nextFrameCycle)
+      {
+        vdpFrameCycle = nextFrameCycle;
+        nextFrameCycle += cyclesPerFrame;
+        vdpIntFlag = true;
+
+        // sprite flags for the frame, from the working vdp (the renderer
+        // sees the guest's writes at real-time frame boundaries). collision
+        // stays set until read, the first fifth sprite wins
+        uint8_t sprites = tmsSpriteStatus();
+        vdpSpriteStatus |= sprites & 0x20;
+        if (!(vdpSpriteStatus & 0x40))
+        {
+          vdpSpriteStatus |= sprites & 0x5f;
+        }
+
+        if ((vrEmuTms9918RegValue(tms9918, TMS_REG_1) & 0x20))
+        {
+          raiseInterrupt(HBC56_TMS9918_IRQ);
+        }
+      }
+
+      if (cycle >= nextFlushCycle)
+      {
+        nextFlushCycle += HBC56_CLOCK_FREQ;
+        replayFlush();
+      }
+    }
+#endif
+
+    if (uartBuffer == 0)
+    {
+      nextUartTime = delayed_by_us(currentTime, 100);
+      int c = uartReadInput();
+      if (c != PICO_ERROR_TIMEOUT)
+      {
+        //        putchar(c);
+        uartBuffer = c;// & 0xff;
+        raiseInterrupt(HBC56_UART_IRQ);
+        uartStatus = UART_STATUS_TX_REG_EMPTY;
+        uartStatus |= UART_STATUS_RX_REG_FULL;
+      }
+      else
+      {
+        releaseInterrupt(HBC56_UART_IRQ);
+        uartStatus &= ~(UART_STATUS_RX_REG_FULL);
+      }
+    }
+
+
+    // has the via interrupted?
+    setOrClearInterrupt(HBC56_VIA_IRQ, *vrEmu6522Int(via) == IntRequested);
+
+    // set cpu interrupt
+    *(vrEmu6502Int(cpu)) = intReg() ? IntRequested : IntCleared;
+
+#if HBC56_MEASURE_CORE0
+    core0BusyUs += time_us_64() - burstStartUs;
+#endif
+
+    // delay or continue immediately to keep cpu clock
+    currentTime = delayed_by_us(currentTime, MICROSECONDS_PER_BURST);
+    if (to_us_since_boot(currentTime) < to_us_since_boot(get_absolute_time()))
+    {
+      currentTime = get_absolute_time();
+    }
+    else
+    {
+#if HBC56_RENDER_HELP
+      // time to spare. render some display lines for core1
+      while (absolute_time_diff_us(get_absolute_time(), currentTime) > HBC56_RENDER_HELP_SLACK_US &&
+             vgaHelpRender())
+      {
+      }
+#endif
+      busy_wait_until(currentTime);
+    }
+  }
+}
+
+
+/*
+ * 65c02 write to the bus
+ */
+void __not_in_flash_func(busWrite)(uint16_t addr, uint8_t val)
+{
+  // ram?
+  if (addr < HBC56_IO_START)
+  {
+    ram[addr] = val;
+#if HBC56_HAVE_REWIND
+    ramWrittenPages[addr / (REWIND_PAGE_BYTES * 32)] |= 1u << ((addr / REWIND_PAGE_BYTES) & 31);
+#endif
+  }
+
+  // io?
+  else if (addr <= HBC56_ROM_START)
+  {
+    if ((addr & HBC56_VIA_PORT) == HBC56_VIA_PORT)
+    {
+      vrEmu6522Write(via, addr & 0x0f, val);
+      setOrClearInterrupt(HBC56_VIA_IRQ, *vrEmu6522Int(via) == IntRequested);
+#if HBC56_HAVE_REWIND
+      switch (addr & 0x0f)
+      {
+        case VIA_REG_ORA_NH: viaWritten[VIA_REG_ORA] = val; break;
+        case VIA_REG_T1CH:   viaTimersArmed |= VIA_IFR_T1; break;
+        case VIA_REG_T2CH:   viaTimersArmed |= VIA_IFR_T2; break;
+        default:             viaWritten[addr & 0x0f] = val; break;
+      }
+#endif
+    }
+    else
+    {
+      switch (addr & 0xff)
+      {
+        case HBC56_TMS9918_PORT:
+          tmsWriteData(val);
+          break;
+
+        case HBC56_TMS9918_PORT | 0x01:
+          tmsSetWriteLine(vdpScanline());
+          tmsWriteAddr(val);
+          break;
+
+        case HBC56_AY38910_A_PORT:
+        case HBC56_AY38910_A_PORT | 0x01:
+          audioWritePsg0(addr, val);
+          break;
+
+        case HBC56_AY38910_B_PORT:
+        case HBC56_AY38910_B_PORT | 0x01:
+          audioWritePsg1(addr, val);
+          break;
+
+        case HBC56_UART_PORT:
+          uartControl = val;
+          if ((val & 0x03) == 0x03)   // reset
+          {
+            uartStatus = UART_STATUS_TX_REG_EMPTY;
+          }
+          else
+          {
+            releaseInterrupt(HBC56_UART_IRQ);
+          }
+          break;
+
+        case HBC56_UART_PORT | 0x01:
+          putchar(val);
+          break;
+
+        case FOPEN_PORT:
+          {
+            uint16_t addr = ram[val] | (ram[val + 1] << 8);
+            char* strAddr = ram + addr;
+            if (*strAddr == '$')
+            {
+              DIR d;
+              FILINFO fno;
+              memset(&d, 0, sizeof d);
+              memset(&fno, 0, sizeof fno);
+
+              int index = 0;
+              FRESULT fr = f_findfirst(&d, &fno, ".", "*.bas");
+              dirListPtr = dirListing;
+
+              while ((FR_OK == fr) && fno.fname[0] && (dirListPtr < (dirListing + sizeof(dirListing) - 32)))
+              {
+                dirListPtr += sprintf(dirListPtr, "%d %-18.18s %7d B\r", index, fno.fname, fno.fsize);
+
+                index++;
+                fr = f_findnext(&d, &fno);
+              }
+              dirListPtr = dirListing;
+            }
+            else
+            {
+              dirListPtr = NULL;
+              f_open(&fil, strAddr, FA_OPEN_ALWAYS | FA_WRITE | FA_READ);
+            }
+          }
+          break;
+
+        case FWRITE_PORT:
+          {
+            uint bw = 0;
+            f_write(&fil, &val, 1, &bw);
+          }
+          break;
+
+        default:
+          // unknown device
+          break;
+      }
+    }
+  }
+}
+
+#define KB_INT_FLAG 0x02
+#define KB_RDY_FLAG 0x04
+
+/*
+ * 65c02 read from the bus
+ */
+uint8_t __not_in_flash_func(busRead)(uint16_t addr, bool isDbg)
+{
+  // rom?
+  if (addr & 0x8000)
+  {
+    return pico56rom[addr & (HBC56_ROM_SIZE - 1)];
+  }
+
+  // ram?
+  else if (addr < HBC56_IO_START)
+  {
+    return ram[addr];
+  }
+
+  // io?
+  else
+  {
+    if ((addr & HBC56_VIA_PORT) == HBC56_VIA_PORT)
+    {
+      uint8_t value = vrEmu6522Read(via, addr & 0x0f);
+      setOrClearInterrupt(HBC56_VIA_IRQ, *vrEmu6522Int(via) == IntRequested);
+      return value;
+    }
+    else
+    {
+      switch (addr & 0xff)
+      {
+        case HBC56_TMS9918_PORT:
+          {
+            return tmsReadData();
+          }
+
+        case HBC56_TMS9918_PORT | 0x01:
+          {
+            uint8_t value = tmsReadStatus();
+            releaseInterrupt(HBC56_TMS9918_IRQ);
+#if HBC56_HAVE_REPLAY
+            if (deterministic)
+            {
+              // every flag comes from emulated time. the renderer's are dropped
+              value = vdpSpriteStatus | (vdpIntFlag ? 0x80 : 0x00);
+              vdpIntFlag = false;
+              vdpSpriteStatus = 0;
+            }
+#endif
+            return value;
+          }
+
+        case HBC56_KB_PORT:
+          {
+            uint8_t value = 0;
+            if (!kbdQueueEmpty())
+            {
+              value = kbdQueuePop();
+            }
+            return value;
+          }
+        case HBC56_KB_PORT | 0x01:
+          {
+            return (!kbdQueueEmpty())
+              ? (KB_INT_FLAG | KB_RDY_FLAG)
+              : 0;
+          }
+        case HBC56_NES_PORT:
+          return nesState1;
+
+        case HBC56_NES_PORT | 0x01:
+          return nesState2;
+
+        case HBC56_IRQ_PORT:
+          return intReg();
+
+        case HBC56_AY38910_A_PORT | 0x02:
+          return audioReadPsg0();
+
+        case HBC56_AY38910_B_PORT | 0x02:
+          return audioReadPsg1();
+
+        case HBC56_UART_PORT:
+          return uartStatus;
+
+        case HBC56_UART_PORT | 0x01:
+          {
+            int c = uartReadInput();
+            if (c == PICO_ERROR_TIMEOUT)
+            {
+              releaseInterrupt(HBC56_UART_IRQ);
+              uartStatus &= ~(UART_STATUS_RX_REG_FULL);
+              c = 0;
+            }
+            uint8_t val = uartBuffer;
+            uartBuffer = c;
+            return val;
+          }
+
+        case FCLOSE_PORT:
+          f_close(&fil);
+          return 0;
+
+        case FREAD_PORT:
+          {
+            uint8_t value = 0;
+            if (dirListPtr)
+            {
+              value = *dirListPtr++;
+              if (value == 0 || (dirListPtr >= (dirListing + sizeof(dirListing))))
+              {
+                dirListPtr = NULL;
+              }
+            }
+            else
+            {
+              uint br = 0;
+              if (f_read(&fil, &value, 1, &br) != FR_OK)
+              {
+                value = 0;
+              }
+            }
+            return value;
+          }
+
+        default:
+          return 0x00;
+      }
+    }
+  }
+}
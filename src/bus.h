@@ -1,18 +1,18 @@
-/*
- * Project: pico-56 - the bus
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-#pragma once
-
-#include <inttypes.h>
-#include <stdbool.h>
-
-void busInit();
+/*
+ * Project: pico-56 - the bus
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+void busInit();
 void busMainLoop();
\ No newline at end of file
@@ -1,25 +1,35 @@
-/*
- * Project: pico-56 - audio
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-#pragma once
-
-#include <inttypes.h>
-
-void audioInit(int psgClock, int sampleRate);
-
-void audioUpdate();
-
-uint8_t audioReadPsg0();
-uint8_t audioReadPsg1();
-
-void audioWritePsg0(uint16_t addr, uint8_t val);
-void audioWritePsg1(uint16_t addr, uint8_t val);
-
+/*
+ * Project: pico-56 - audio
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <inttypes.h>
+
+#define AUDIO_PSG_REGISTERS 16
+
+// both psgs: registers and the selected register
+#define AUDIO_STATE_BYTES   (2 * (AUDIO_PSG_REGISTERS + 1))
+
+void audioInit(int psgClock, int sampleRate);
+
+void audioUpdate();
+
+uint8_t audioReadPsg0();
+uint8_t audioReadPsg1();
+
+void audioWritePsg0(uint16_t addr, uint8_t val);
+void audioWritePsg1(uint16_t addr, uint8_t val);
+
+/*
+ * save/restore the psg registers (AUDIO_STATE_BYTES)
+ */
+void audioSaveState(uint8_t* state);
+void audioRestoreState(const uint8_t* state);
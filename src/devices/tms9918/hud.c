@@ -0,0 +1,197 @@
+/*
+ * Project: pico-56 - performance hud
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "hud.h"
+
+#include "pico/stdlib.h"
+
+#include <ctype.h>
+
+ /*
+  * the hud text is converted to a list of horizontal spans for each font row
+  * when it is set (core0). drawing a row (core1) is then just a few fills
+  */
+
+#define HUD_MAX_SPANS    128      // per row
+#define HUD_LEFT         2        // first pixel column
+
+typedef struct
+{
+  uint16_t x;
+  uint16_t length;
+} HudSpan;
+
+typedef struct
+{
+  HudSpan spans[HUD_ROWS][HUD_MAX_SPANS];
+  uint16_t count[HUD_ROWS];
+} HudSpans;
+
+static HudSpans hudSpans[2];
+static volatile int hudFront = 0;
+static volatile bool hudShown = false;
+
+/*
+ * 3x4 font (ascii 32 - 95). three bits per row, top row in the high bits
+ */
+#define G(r0, r1, r2, r3) ((r0 << 9) | (r1 << 6) | (r2 << 3) | r3)
+
+static const uint16_t hudFont[64] = {
+  G(0b000, 0b000, 0b000, 0b000),  // space
+  G(0b010, 0b010, 0b000, 0b010),  // !
+  G(0b101, 0b101, 0b000, 0b000),  // "
+  G(0b101, 0b111, 0b111, 0b101),  // #
+  G(0b011, 0b110, 0b011, 0b110),  // $
+  G(0b101, 0b001, 0b100, 0b101),  // %
+  G(0b010, 0b101, 0b010, 0b111),  // &
+  G(0b010, 0b010, 0b000, 0b000),  // '
+  G(0b001, 0b010, 0b010, 0b001),  // (
+  G(0b100, 0b010, 0b010, 0b100),  // )
+  G(0b101, 0b010, 0b101, 0b000),  // *
+  G(0b000, 0b010, 0b111, 0b010),  // +
+  G(0b000, 0b000, 0b010, 0b100),  // ,
+  G(0b000, 0b111, 0b000, 0b000),  // -
+  G(0b000, 0b000, 0b000, 0b010),  // .
+  G(0b001, 0b010, 0b010, 0b100),  // /
+  G(0b111, 0b101, 0b101, 0b111),  // 0
+  G(0b110, 0b010, 0b010, 0b111),  // 1
+  G(0b110, 0b001, 0b010, 0b111),  // 2
+  G(0b111, 0b011, 0b001, 0b111),  // 3
+  G(0b101, 0b101, 0b111, 0b001),  // 4
+  G(0b111, 0b110, 0b001, 0b110),  // 5
+  G(0b100, 0b111, 0b101, 0b111),  // 6
+  G(0b111, 0b001, 0b010, 0b010),  // 7
+  G(0b111, 0b010, 0b101, 0b111),  // 8
+  G(0b111, 0b101, 0b111, 0b001),  // 9
+  G(0b000, 0b010, 0b000, 0b010),  // :
+  G(0b000, 0b010, 0b000, 0b110),  // ;
+  G(0b001, 0b010, 0b010, 0b001),  // <
+  G(0b000, 0b111, 0b000, 0b111),  // =
+  G(0b100, 0b010, 0b010, 0b100),  // >
+  G(0b110, 0b001, 0b000, 0b010),  // ?
+  G(0b111, 0b101, 0b100, 0b111),  // @
+  G(0b010, 0b101, 0b111, 0b101),  // A
+  G(0b110, 0b111, 0b101, 0b110),  // B
+  G(0b011, 0b100, 0b100, 0b011),  // C
+  G(0b110, 0b101, 0b101, 0b110),  // D
+  G(0b111, 0b110, 0b100, 0b111),  // E
+  G(0b111, 0b100, 0b110, 0b100),  // F
+  G(0b011, 0b100, 0b101, 0b011),  // G
+  G(0b101, 0b111, 0b101, 0b101),  // H
+  G(0b111, 0b010, 0b010, 0b111),  // I
+  G(0b001, 0b001, 0b101, 0b010),  // J
+  G(0b101, 0b110, 0b110, 0b101),  // K
+  G(0b100, 0b100, 0b100, 0b111),  // L
+  G(0b101, 0b111, 0b111, 0b101),  // M
+  G(0b110, 0b101, 0b101, 0b101),  // N
+  G(0b010, 0b101, 0b101, 0b010),  // O
+  G(0b110, 0b101, 0b110, 0b100),  // P
+  G(0b010, 0b101, 0b111, 0b011),  // Q
+  G(0b110, 0b101, 0b110, 0b101),  // R
+  G(0b011, 0b110, 0b001, 0b110),  // S
+  G(0b111, 0b010, 0b010, 0b010),  // T
+  G(0b101, 0b101, 0b101, 0b111),  // U
+  G(0b101, 0b101, 0b101, 0b010),  // V
+  G(0b101, 0b101, 0b111, 0b111),  // W
+  G(0b101, 0b010, 0b010, 0b101),  // X
+  G(0b101, 0b101, 0b010, 0b010),  // Y
+  G(0b111, 0b011, 0b100, 0b111),  // Z
+  G(0b011, 0b010, 0b010, 0b011),  // [
+  G(0b100, 0b010, 0b010, 0b001),  // backslash
+  G(0b110, 0b010, 0b010, 0b110),  // ]
+  G(0b010, 0b101, 0b000, 0b000),  // ^
+  G(0b000, 0b000, 0b000, 0b111),  // _
+};
+
+#undef G
+
+/*
+ * show/hide the hud
+ */
+void hudShow(bool show)
+{
+  hudShown = show;
+}
+
+/*
+ * is the hud visible?
+ */
+bool hudVisible()
+{
+  return hudShown;
+}
+
+/*
+ * set the hud text (one line, upper case, digits and a little punctuation),
+ * clipped to width pixels
+ */
+void hudSetText(const char* text, uint16_t width)
+{
+  HudSpans* back = &hudSpans[hudFront ^ 1];
+
+  for (int row = 0; row < HUD_ROWS; ++row)
+  {
+    back->count[row] = 0;
+  }
+
+  uint16_t x = HUD_LEFT;
+  for (; *text && (x + HUD_FONT_WIDTH) <= width; ++text, x += HUD_FONT_WIDTH + 1)
+  {
+    int c = toupper(*text);
+    if (c < ' ' || c > '_') c = '?';
+    uint16_t glyph = hudFont[c - ' '];
+
+    for (int row = 0; row < HUD_ROWS; ++row)
+    {
+      uint8_t bits = (glyph >> ((HUD_ROWS - 1 - row) * HUD_FONT_WIDTH)) & 0x07;
+      for (int col = 0; col < HUD_FONT_WIDTH; ++col)
+      {
+        if (!(bits & (0x04 >> col))) continue;
+
+        // extend the previous span or start a new one
+        uint16_t px = x + col;
+        uint16_t count = back->count[row];
+        HudSpan* last = count ? &back->spans[row][count - 1] : NULL;
+        if (last && last->x + last->length == px)
+        {
+          ++last->length;
+        }
+        else if (count < HUD_MAX_SPANS)
+        {
+          back->spans[row][count].x = px;
+          back->spans[row][count].length = 1;
+          back->count[row] = count + 1;
+        }
+      }
+    }
+  }
+
+  hudFront ^= 1;
+}
+
+/*
+ * draw hud row (0 to HUD_ROWS - 1) over a line of pixels
+ */
+void __time_critical_func(hudDrawRow)(uint16_t row, uint16_t* pixels, uint16_t colour)
+{
+  const HudSpans* front = &hudSpans[hudFront];
+  const HudSpan* span = front->spans[row];
+  const HudSpan* end = span + front->count[row];
+
+  for (; span < end; ++span)
+  {
+    uint16_t* dst = pixels + span->x;
+    for (int i = 0; i < span->length; ++i)
+    {
+      dst[i] = colour;
+    }
+  }
+}
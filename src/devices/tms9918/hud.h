@@ -0,0 +1,33 @@
+/*
+ * Project: pico-56 - performance hud
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#define HUD_FONT_WIDTH   3
+#define HUD_FONT_HEIGHT  4
+#define HUD_ROWS         HUD_FONT_HEIGHT
+
+void hudShow(bool show);
+bool hudVisible();
+
+/*
+ * set the hud text (one line, upper case, digits and a little punctuation),
+ * clipped to width pixels
+ */
+void hudSetText(const char* text, uint16_t width);
+
+/*
+ * draw hud row (0 to HUD_ROWS - 1) over a line of pixels
+ */
+void hudDrawRow(uint16_t row, uint16_t* pixels, uint16_t colour);
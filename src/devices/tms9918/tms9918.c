@@ -1,204 +1,1802 @@
-/*
- * Project: pico-56 - tms9918
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-#include "tms9918.h"
-#include "vrEmuTms9918Util.h"
-
-#include "vga.h"
-#include "vga-modes.h"
-#include "interrupts.h"
-
-#include "pico/stdlib.h"
-#include "hardware/clocks.h"
-
-#include "pico/divider.h"
-
-static VrEmuTms9918* tms = NULL;
-static vgaEndOfFrameFn eofCallback = NULL;
-static vgaEndOfScanlineFn scanlineCallback = NULL;
-
-static uint16_t __aligned(4) tmsPal[16];
-static uint8_t __aligned(4) tmsScanlineBuffer[TMS9918_PIXELS_X];
-
-/*
- * convert 48-bit rgb to 12-bit bgr
- */
-static uint16_t colorFromRgb(uint16_t r, uint16_t g, uint16_t b)
-{
-  return
-    ((uint16_t)(r / 16.0f) & 0x0f) |
-    (((uint16_t)(g / 16.0f) & 0x0f) << 4) |
-    (((uint16_t)(b / 16.0f) & 0x0f) << 8);
-}
-
-/*
- * vga scanline callback for tms9918
- */
-static void tmsScanline(uint16_t y, VgaParams* params, uint16_t* pixels)
-{
-  const uint32_t vBorder = (params->vVirtualPixels - TMS9918_PIXELS_Y) / 2;
-  const uint32_t hBorder = (params->hVirtualPixels - TMS9918_PIXELS_X) / 2;
-
-  uint16_t bg = tmsPal[vrEmuTms9918RegValue(tms, TMS_REG_FG_BG_COLOR) & 0x0f];
-
-  // top or bottom border
-  if (y < vBorder || y >= (vBorder + TMS9918_PIXELS_Y))
-  {
-    for (int x = 0; x < params->hVirtualPixels; ++x)
-    {
-      pixels[x] = bg;
-    }
-    return;
-  }
-
-  y -= vBorder;
-
-  // left border
-  for (int x = 0; x < hBorder; ++x)
-  {
-    pixels[x] = bg;
-  }
-
-  // get scanline data from the tms9918
-  vrEmuTms9918ScanLine(tms, y, tmsScanlineBuffer);
-
-  // convert to our 12-bit palette and output to pixels array
-  int tmsX = 0;
-  for (int x = hBorder; x < hBorder + TMS9918_PIXELS_X; ++x, ++tmsX)
-  {
-    pixels[x] = tmsPal[tmsScanlineBuffer[tmsX]];
-  }
-
-  // right border
-  for (int x = hBorder + TMS9918_PIXELS_X; x < params->hVirtualPixels; ++x)
-  {
-    pixels[x] = bg;
-  }
-
-  // interrupt?
-  if (y == TMS9918_PIXELS_Y - 1)
-  {
-    if ((vrEmuTms9918RegValue(tms, TMS_REG_1) & 0x20))
-    {
-      raiseInterrupt(1);
-    }
-  }
-}
-
-/*
- * set callback for end of frame events
- */
-void tmsSetFrameCallback(vgaEndOfFrameFn cb)
-{
-  eofCallback = cb;
-}
-
-/*
- * set callback for end of scanline events
- */
-void tmsSetHsyncCallback(vgaEndOfScanlineFn cb)
-{
-  scanlineCallback = cb;
-}
-
-/*
- * get vga horizontal frequency in Hz
- */
-int tmsGetHsyncFreq()
-{
-  return vgaCurrentParams().params.hSyncParams.freqHz;
-}
-
-/*
- * vga end-of-frame callback for tms9918
- */
-static void tmsEndOfFrame(uint64_t frameNumber)
-{
-  if (eofCallback) eofCallback(frameNumber);
-}
-
-/*
- * vga end-of-scanline callback for tms9918
- */
-static void tmsEndOfScanline()
-{
-  if (scanlineCallback) scanlineCallback();
-}
-
-static const uint32_t MAX_CLOCK = 270000;
-
-void setClosestClockFreqKhz(uint32_t clockKHz)
-{
-  if (clockKHz > MAX_CLOCK) clockKHz = MAX_CLOCK;
-
-  clockKHz /= 10;
-  clockKHz *= 10;
-
-  uint32_t offset = 0;
-  while (!set_sys_clock_khz(clockKHz + offset, false)) {
-    offset += 10;
-    if (set_sys_clock_khz(clockKHz - offset, false)) break;
-  }
-}
-
-/*
- * tms9918 initialisation
- */
-VrEmuTms9918* tmsInit()
-{
-  tms = vrEmuTms9918New();
-
-  // build up tms9918 palette optimized for 12-bit vga
-  for (int c = 0; c < 16; ++c)
-  {
-    uint32_t rgba8 = vrEmuTms9918Palette[c];
-    tmsPal[c] = colorFromRgb(
-      (rgba8 & 0xff000000) >> 24,
-      (rgba8 & 0x00ff0000) >> 16,
-      (rgba8 & 0x0000ff00) >> 8);
-  }
-
-  VgaInitParams params;
-  params.params = vgaGetParams(VGA_800_600_60HZ, 3);
-  params.scanlineFn = tmsScanline;
-  params.endOfFrameFn = tmsEndOfFrame;
-  params.endOfScanlineFn = tmsEndOfScanline;
-
-  uint32_t minSysClockFreq = vgaMinimumPioClockKHz(&params.params);
-  uint32_t sysClockFreq = minSysClockFreq;
-  while (sysClockFreq + minSysClockFreq < MAX_CLOCK)
-  {
-    sysClockFreq += minSysClockFreq;
-  }
-
-  setClosestClockFreqKhz(sysClockFreq);
-
-  vgaInit(params);
-
-  return tms;
-}
-
-VrEmuTms9918* getTms9918()
-{
-  return tms;
-}
-
-/*
- * tms9918 destruction
- */
-void tmsDestroy()
-{
-  if (tms)
-  {
-    vrEmuTms9918Destroy(tms);
-    tms = NULL;
-  }
-}
+/*
+ * Project: pico-56 - tms9918
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "tms9918.h"
+#include "vrEmuTms9918Util.h"
+#include "hud.h"
+
+#include "vga.h"
+#include "vga-modes.h"
+#include "interrupts.h"
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/interp.h"
+#include "hardware/structs/systick.h"
+
+#include "pico/divider.h"
+#include "pico/sync.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef TMS9918_INTERP_PALETTE
+#define TMS9918_INTERP_PALETTE 1    // use the interpolator to generate palette addresses
+#endif
+
+#ifndef TMS9918_BENCHMARK
+#define TMS9918_BENCHMARK 0         // print palette conversion cycle counts at startup
+#endif
+
+#define TMS_STATUS_INT        0x80
+#define TMS_STATUS_5S         0x40
+#define TMS_STATUS_COL        0x20
+#define TMS_STATUS_5S_NUM     0x1f
+
+#define TMS_WRITE_LOG_SIZE    4096          // power of 2
+#define TMS_WRITE_LOG_REG     0x80000000    // entry is a register write (else vram)
+#define TMS_WRITE_LOG_LINE_SHIFT 22         // register writes: emulated scanline (9 bits)
+#define TMS_WRITE_LOG_LINE_MASK  0x1ff
+
+#define TMS_RASTER_QUEUE_SIZE 256
+
+#define TMS_SYNC_MAX_ENTRIES  1024          // log entries replayed per frame
+#define TMS_RESYNC_PAGES      8             // vram pages copied per frame while resyncing
+
+static VrEmuTms9918* tms = NULL;        // working vdp (written by core0)
+static VrEmuTms9918* volatile renderTms = NULL;  // vdp being rendered (read by core1)
+static VrEmuTms9918* tmsRenderInstance = NULL;
+static vgaEndOfFrameFn eofCallback = NULL;
+static vgaEndOfScanlineFn scanlineCallback = NULL;
+static bool scanlineIrqEnabled = true;
+
+static VgaMode tmsVgaMode = VGA_800_600_60HZ;
+static int tmsPixelScale = 3;
+
+/*
+ * double-buffered vram
+ *
+ * core0 writes to the working vdp and logs each decoded vram / register
+ * write. at the end of each frame, core1 replays the log into its own render
+ * vdp (up to TMS_SYNC_MAX_ENTRIES a frame), so a frame normally shows only
+ * complete updates.
+ *
+ * if the log overflows (or when double buffering starts), core1 renders the
+ * working vdp directly while it copies the vram shadow to the render vdp,
+ * TMS_RESYNC_PAGES a frame. pages written in the meantime are copied again
+ */
+static bool logWrites = false;                // core0
+static volatile bool doubleBufferRequested = false;
+
+static uint32_t writeLog[TMS_WRITE_LOG_SIZE];
+static volatile uint32_t writeLogHead = 0;    // written by core0
+static volatile uint32_t writeLogTail = 0;    // written by core1
+static volatile uint32_t writeLogDrops = 0;   // written by core0
+static uint32_t syncedDrops = 0;              // core1
+
+/*
+ * vram shadow (core0)
+ *
+ * a plain copy of the working vdp's vram, kept up to date by tmsWriteData,
+ * along with the vdp address register. each 256 byte page has a written
+ * flag for callers (rewind) to clear
+ */
+static uint8_t* vramShadow = NULL;
+static uint32_t vramWrittenPages[(TMS_VRAM_PAGES + 31) / 32];
+
+static uint8_t addrLatch = 0;                 // core0 copy of the vdp address register
+static bool addrStage = false;
+static uint16_t vramAddr = 0;
+
+static uint16_t renderAddr = 0;               // core1 copy of the render vdp address register
+#define TMS_RENDER_ADDR_UNKNOWN 0xffff
+
+static bool resyncing = false;                // core1
+static uint32_t resyncPages[(TMS_VRAM_PAGES + 31) / 32];  // core1. pages still to copy
+
+static uint16_t writeLine = TMS_LINE_NONE;    // core0 emulated scanline of register writes
+static volatile uint32_t vblankCount = 0;     // written by core1
+
+/*
+ * raster register writes (core1)
+ *
+ * register writes logged during the display (tagged with the emulated
+ * scanline) are held back when the log is replayed and applied by
+ * tmsScanline when the next frame reaches that line, so mid-frame splits
+ * land where the guest put them. line TMS9918_PIXELS_Y means after the display
+ */
+typedef struct
+{
+  uint16_t line;
+  uint8_t reg;
+  uint8_t value;
+} TmsRasterWrite;
+
+static TmsRasterWrite rasterQueue[TMS_RASTER_QUEUE_SIZE];
+static volatile uint32_t rasterCount = 0;    // read by core0 (tmsHelperFilter)
+static uint32_t rasterNext = 0;
+
+static spin_lock_t* statusLock = NULL;
+static volatile uint8_t renderStatus = 0;     // status flags raised by the render vdp
+
+static uint16_t __aligned(4) tmsPal[16];
+static uint32_t __aligned(4) tmsDpal[256];  // two pixels (low nibble first) per entry
+static uint8_t __aligned(4) tmsScanlineBuffer[TMS9918_PIXELS_X];
+
+#define TMS_MARGIN_CACHE VGA_LINE_BUFFERS
+
+// full border lines (sent to the rgb dma as-is). two, so we never modify
+// the one being displayed
+static uint16_t* tmsBorderLines[2] = { NULL, NULL };
+static int tmsBorderLineIndex = 0;
+static int32_t tmsBorderLineBg = -1;
+
+// vga ring buffers with margins already filled (and the colour they were filled with)
+static uint16_t* tmsMarginBuffers[TMS_MARGIN_CACHE];
+static uint16_t tmsMarginBg[TMS_MARGIN_CACHE];
+static int tmsMarginNext = 0;
+
+#define TMS_PACKED_LINE_BYTES (TMS9918_PIXELS_X / 2)
+
+/*
+ * per-line render cache (4bpp, two pixels per byte)
+ *
+ * only used with double-buffered vram, where core1 sees each write as it is
+ * replayed. lines are re-rendered when a write touches their name table row,
+ * pattern/colour row, when the sprites on the line change or after any
+ * register change
+ */
+typedef struct
+{
+  uint16_t nameAddr;
+  uint16_t nameSize;
+  uint16_t nameCols;
+  uint16_t pattAddr;
+  uint16_t pattSize;
+  uint16_t colorAddr;
+  uint16_t colorSize;
+  uint16_t spritePattAddr;
+  vrEmuTms9918Mode mode;
+} TmsLayout;
+
+#define TMS_MAX_SPRITES        32
+#define TMS_MAX_LINE_SPRITES   4
+#define TMS_SPRITE_TERMINATOR  0xd0
+
+/*
+ * visible sprites on a line (built once per frame)
+ */
+typedef struct
+{
+  uint8_t count;
+  uint8_t fifth;                              // fifth sprite number (or 0xff)
+  uint8_t sprites[TMS_MAX_LINE_SPRITES];
+} TmsSpriteLine;
+
+#define TMS_SPRITE_EARLY_CLOCK 0x80
+
+/*
+ * a sprite's attributes (decoded)
+ */
+typedef struct
+{
+  int16_t y;                                  // top line
+  int16_t x;                                  // left pixel (early clock applied)
+  uint8_t name;
+  uint8_t colour;
+} TmsSprite;
+
+static uint8_t* tmsLineCache = NULL;
+static uint8_t* tmsLineCacheAlloc = NULL;
+static uint8_t __aligned(4) tmsPackedScratch[TMS_PACKED_LINE_BYTES];
+static bool tmsLineDirty[TMS9918_PIXELS_Y];
+static uint8_t tmsLineStatus[TMS9918_PIXELS_Y];   // status flags raised when the line was rendered
+static TmsSprite tmsSprites[TMS_MAX_SPRITES];
+static TmsSpriteLine tmsSpriteLines[TMS9918_PIXELS_Y];
+static bool tmsSpriteLinesStale = true;     // a raster write changed the sprite setup
+static uint32_t tmsSpriteSignature[TMS9918_PIXELS_Y];  // sprite attributes on each line (0 = none)
+static bool tmsSpritePattsDirty = false;
+static TmsLayout tmsLayout;
+
+/*
+ * lines expanded by the helper (core0)
+ *
+ * the helper only expands cached lines, so it never touches the render vdp.
+ * the per-line caches and the margin cache belong to core1. the helper only
+ * reads the line caches (the frame is frozen while it runs: core1 waits for
+ * it before the end of frame sync, and it never takes lines while raster
+ * writes are queued). it fills the margins of the buffers it renders, and
+ * passes the colour back through here so core1 can retag its margin cache
+ */
+#define TMS_HELPER_RESULTS 8    // power of two
+
+typedef struct
+{
+  uint16_t* pixels;
+  uint16_t bg;
+} TmsHelperResult;
+
+static TmsHelperResult helperResults[TMS_HELPER_RESULTS];
+static volatile uint32_t helperResultHead = 0;   // written by core0
+static volatile uint32_t helperResultTail = 0;   // written by core1
+
+/*
+ * convert 48-bit rgb to 12-bit bgr
+ */
+static uint16_t colorFromRgb(uint16_t r, uint16_t g, uint16_t b)
+{
+  return
+    ((uint16_t)(r / 16.0f) & 0x0f) |
+    (((uint16_t)(g / 16.0f) & 0x0f) << 4) |
+    (((uint16_t)(b / 16.0f) & 0x0f) << 8);
+}
+
+/*
+ * convert a line of tms9918 palette indices to 12-bit pixels (table lookup)
+ *  - four pixels are read at a time and each pair of (4-bit) palette indices
+ *    folded into a single byte to look up two output pixels at once
+ *  - the folded (4bpp) line is also written to packed
+ */
+static inline void __time_critical_func(tmsConvertLut)(const uint32_t* src, uint16_t* packed, uint32_t* dst)
+{
+  for (int i = 0; i < TMS9918_PIXELS_X / 4; ++i)
+  {
+    uint32_t quad = src[i];
+    quad |= quad >> 4;
+    packed[i] = (quad & 0xff) | ((quad >> 8) & 0xff00);
+    dst[0] = tmsDpal[quad & 0xff];
+    dst[1] = tmsDpal[(quad >> 16) & 0xff];
+    dst += 2;
+  }
+}
+
+/*
+ * expand a packed (4bpp) line to 12-bit pixels (table lookup)
+ */
+static inline void __time_critical_func(tmsExpandLut)(const uint8_t* packed, uint32_t* dst)
+{
+  for (int i = 0; i < TMS9918_PIXELS_X / 2; ++i)
+  {
+    dst[i] = tmsDpal[packed[i]];
+  }
+}
+
+/*
+ * expand a packed (4bpp) line to 12-bit pixels, one pixel late (table lookup)
+ *  - for odd borders: dst starts a pixel before the line and the first
+ *    pixel is the first nibble. returns the last pixel (not written)
+ */
+static inline uint32_t __time_critical_func(tmsExpandShiftedLut)(const uint8_t* packed, uint32_t first, uint32_t* dst)
+{
+  const uint32_t* src = (const uint32_t*)packed;
+  uint32_t carry = first;
+  for (int i = 0; i < TMS9918_PIXELS_X / 8; ++i)
+  {
+    uint32_t octet = src[i];
+    uint32_t shifted = (octet << 4) | carry;
+    carry = octet >> 28;
+    dst[0] = tmsDpal[shifted & 0xff];
+    dst[1] = tmsDpal[(shifted >> 8) & 0xff];
+    dst[2] = tmsDpal[(shifted >> 16) & 0xff];
+    dst[3] = tmsDpal[shifted >> 24];
+    dst += 4;
+  }
+  return carry;
+}
+
+/*
+ * fold a line of tms9918 palette indices to packed (4bpp) pixels
+ */
+static inline void __time_critical_func(tmsPack)(const uint32_t* src, uint16_t* packed)
+{
+  for (int i = 0; i < TMS9918_PIXELS_X / 4; ++i)
+  {
+    uint32_t quad = src[i];
+    quad |= quad >> 4;
+    packed[i] = (quad & 0xff) | ((quad >> 8) & 0xff00);
+  }
+}
+
+/*
+ * configure the calling core's interp0 to generate tmsDpal addresses
+ *  - lane 0: pixels 0 and 1 of a quad, lane 1: pixels 2 and 3
+ */
+static void tmsInitInterp()
+{
+  interp_config cfg = interp_default_config();
+  interp_config_set_shift(&cfg, 0);
+  interp_config_set_mask(&cfg, 2, 9);
+  interp_set_config(interp0, 0, &cfg);
+
+  interp_config_set_shift(&cfg, 16);
+  interp_config_set_cross_input(&cfg, true);
+  interp_set_config(interp0, 1, &cfg);
+
+  interp0->base[0] = (uint32_t)tmsDpal;
+  interp0->base[1] = (uint32_t)tmsDpal;
+}
+
+/*
+ * convert a line of tms9918 palette indices to 12-bit pixels (interpolator)
+ */
+static inline void __time_critical_func(tmsConvertInterp)(const uint32_t* src, uint16_t* packed, uint32_t* dst)
+{
+  for (int i = 0; i < TMS9918_PIXELS_X / 4; ++i)
+  {
+    uint32_t quad = src[i];
+    quad |= quad >> 4;
+    packed[i] = (quad & 0xff) | ((quad >> 8) & 0xff00);
+    interp0->accum[0] = quad << 2;
+    dst[0] = *(uint32_t*)interp0->peek[0];
+    dst[1] = *(uint32_t*)interp0->peek[1];
+    dst += 2;
+  }
+}
+
+/*
+ * expand a packed (4bpp) line to 12-bit pixels (interpolator)
+ *  - each word holds four pixel pairs: lanes give pairs 0 and 2, then 1 and 3
+ */
+static inline void __time_critical_func(tmsExpandInterp)(const uint8_t* packed, uint32_t* dst)
+{
+  const uint32_t* src = (const uint32_t*)packed;
+  for (int i = 0; i < TMS9918_PIXELS_X / 8; ++i)
+  {
+    uint32_t octet = src[i];
+    interp0->accum[0] = octet << 2;
+    dst[0] = *(uint32_t*)interp0->peek[0];
+    dst[2] = *(uint32_t*)interp0->peek[1];
+    interp0->accum[0] = octet >> 6;
+    dst[1] = *(uint32_t*)interp0->peek[0];
+    dst[3] = *(uint32_t*)interp0->peek[1];
+    dst += 4;
+  }
+}
+
+/*
+ * expand a packed (4bpp) line to 12-bit pixels, one pixel late (interpolator)
+ *  - see tmsExpandShiftedLut
+ */
+static inline uint32_t __time_critical_func(tmsExpandShiftedInterp)(const uint8_t* packed, uint32_t first, uint32_t* dst)
+{
+  const uint32_t* src = (const uint32_t*)packed;
+  uint32_t carry = first;
+  for (int i = 0; i < TMS9918_PIXELS_X / 8; ++i)
+  {
+    uint32_t octet = src[i];
+    uint32_t shifted = (octet << 4) | carry;
+    carry = octet >> 28;
+    interp0->accum[0] = shifted << 2;
+    dst[0] = *(uint32_t*)interp0->peek[0];
+    dst[2] = *(uint32_t*)interp0->peek[1];
+    interp0->accum[0] = shifted >> 6;
+    dst[1] = *(uint32_t*)interp0->peek[0];
+    dst[3] = *(uint32_t*)interp0->peek[1];
+    dst += 4;
+  }
+  return carry;
+}
+
+/*
+ * expand a packed (4bpp) line to 12-bit pixels at dst. with an odd border,
+ * dst is a pixel early: it starts with the last border pixel and the line
+ * runs a word further to the first pixel of the right border
+ */
+static inline void __time_critical_func(tmsExpandLine)(const uint8_t* packed, uint32_t* dst, bool oddBorder, uint32_t bgIndex)
+{
+  if (!oddBorder)
+  {
+#if TMS9918_INTERP_PALETTE
+    tmsExpandInterp(packed, dst);
+#else
+    tmsExpandLut(packed, dst);
+#endif
+    return;
+  }
+
+#if TMS9918_INTERP_PALETTE
+  uint32_t last = tmsExpandShiftedInterp(packed, bgIndex, dst);
+#else
+  uint32_t last = tmsExpandShiftedLut(packed, bgIndex, dst);
+#endif
+  dst[TMS9918_PIXELS_X / 2] = tmsDpal[last | (bgIndex << 4)];
+}
+
+/*
+ * convert a line of tms9918 palette indices to packed (4bpp) and 12-bit
+ * pixels at dst (see tmsExpandLine for odd borders)
+ */
+static inline void __time_critical_func(tmsConvertLine)(const uint8_t* src, uint8_t* packed, uint32_t* dst, bool oddBorder, uint32_t bgIndex)
+{
+  if (oddBorder)
+  {
+    tmsPack((const uint32_t*)src, (uint16_t*)packed);
+    tmsExpandLine(packed, dst, oddBorder, bgIndex);
+    return;
+  }
+
+#if TMS9918_INTERP_PALETTE
+  tmsConvertInterp((const uint32_t*)src, (uint16_t*)packed, dst);
+#else
+  tmsConvertLut((const uint32_t*)src, (uint16_t*)packed, dst);
+#endif
+}
+
+/*
+ * pass status flags from the render vdp on to core0
+ */
+static void __time_critical_func(tmsMergeStatus)(uint8_t status)
+{
+  uint32_t save = spin_lock_blocking(statusLock);
+  uint8_t flags = renderStatus | (status & (TMS_STATUS_INT | TMS_STATUS_COL));
+  if (!(flags & TMS_STATUS_5S))
+  {
+    flags = (flags & ~(TMS_STATUS_5S | TMS_STATUS_5S_NUM)) | (status & (TMS_STATUS_5S | TMS_STATUS_5S_NUM));
+  }
+  renderStatus = flags;
+  spin_unlock(statusLock, save);
+}
+
+static uint32_t tmsSpriteRowBits(VrEmuTms9918* vdp, const TmsSprite* sprite, int y, uint8_t reg1, uint16_t pattAddr);
+static bool tmsSpritePlace(uint32_t* line, int x, uint32_t bits);
+
+/*
+ * background of line y without the sprites: the sprite table is cut short
+ * (the first sprite's y set to the terminator) for the scanline
+ */
+static void __time_critical_func(tmsScanLineBackground)(VrEmuTms9918* vdp, uint16_t y, uint8_t* pixels)
+{
+  uint16_t attrAddr = (vrEmuTms9918RegValue(vdp, TMS_REG_SPRITE_ATTR_TABLE) & 0x7f) << 7;
+  uint8_t firstY = vrEmuTms9918VramValue(vdp, attrAddr);
+
+  vrEmuTms9918SetAddressWrite(vdp, attrAddr);
+  vrEmuTms9918WriteData(vdp, TMS_SPRITE_TERMINATOR);
+
+  vrEmuTms9918ScanLine(vdp, y, pixels);
+
+  vrEmuTms9918SetAddressWrite(vdp, attrAddr);
+  vrEmuTms9918WriteData(vdp, firstY);
+  renderAddr = TMS_RENDER_ADDR_UNKNOWN;
+}
+
+/*
+ * draw the sprites listed for line y over the background (core1). only
+ * those sprites are touched. returns the status flags they raise
+ */
+static uint8_t __time_critical_func(tmsDrawSprites)(VrEmuTms9918* vdp, uint16_t y, const TmsSpriteLine* line, uint8_t* pixels)
+{
+  uint8_t reg1 = vrEmuTms9918RegValue(vdp, TMS_REG_1);
+  if (!(reg1 & 0x40)) return 0;
+
+  uint16_t pattAddr = (vrEmuTms9918RegValue(vdp, TMS_REG_SPRITE_PATT_TABLE) & 0x07) << 11;
+
+  uint8_t status = 0;
+  if (line->count > TMS_MAX_LINE_SPRITES)
+  {
+    status |= TMS_STATUS_5S | line->fifth;
+  }
+
+  // sprite pixels so far (for collisions) and pixels already coloured by a
+  // higher priority sprite. transparent sprites collide, but don't cover
+  uint32_t occupied[TMS9918_PIXELS_X / 32] = { 0 };
+  uint32_t drawn[TMS9918_PIXELS_X / 32] = { 0 };
+
+  int visible = line->count > TMS_MAX_LINE_SPRITES ? TMS_MAX_LINE_SPRITES : line->count;
+  for (int i = 0; i < visible; ++i)
+  {
+    const TmsSprite* sprite = &tmsSprites[line->sprites[i]];
+    uint32_t bits = tmsSpriteRowBits(vdp, sprite, y, reg1, pattAddr);
+
+    if (tmsSpritePlace(occupied, sprite->x, bits))
+    {
+      status |= TMS_STATUS_COL;
+    }
+
+    if (!sprite->colour) continue;
+
+    while (bits)
+    {
+      int bit = __builtin_clz(bits);
+      bits &= ~(0x80000000u >> bit);
+
+      int x = sprite->x + bit;
+      if (x < 0 || x >= TMS9918_PIXELS_X) continue;
+
+      uint32_t mask = 0x80000000u >> (x & 31);
+      if (!(drawn[x >> 5] & mask))
+      {
+        drawn[x >> 5] |= mask;
+        pixels[x] = sprite->colour;
+      }
+    }
+  }
+  return status;
+}
+
+/*
+ * render a line from the vdp. with the per-line sprite lists, sprite lines
+ * only touch the sprites on that line
+ */
+static void __time_critical_func(tmsRenderLine)(VrEmuTms9918* vdp, uint16_t y, uint8_t* packed, uint32_t* dst, bool oddBorder, uint32_t bgIndex)
+{
+  const TmsSpriteLine* sprites = NULL;
+  if (vdp != tms && tmsLineCache && !tmsSpriteLinesStale && tmsSpriteLines[y].count)
+  {
+    sprites = &tmsSpriteLines[y];
+  }
+
+  // get scanline data from the tms9918
+  if (sprites)
+  {
+    tmsScanLineBackground(vdp, y, tmsScanlineBuffer);
+  }
+  else
+  {
+    vrEmuTms9918ScanLine(vdp, y, tmsScanlineBuffer);
+  }
+
+  // pass on any status flags raised by the render vdp
+  if (vdp != tms)
+  {
+    uint8_t status = vrEmuTms9918ReadStatus(vdp);
+    if (sprites)
+    {
+      status = (status & TMS_STATUS_INT) | tmsDrawSprites(vdp, y, sprites, tmsScanlineBuffer);
+    }
+    tmsLineStatus[y] = status & (TMS_STATUS_COL | TMS_STATUS_5S | TMS_STATUS_5S_NUM);
+    tmsMergeStatus(status);
+  }
+
+  // convert to our 12-bit palette and output to pixels array
+  tmsConvertLine(tmsScanlineBuffer, packed, dst, oddBorder, bgIndex);
+
+  tmsLineDirty[y] = false;
+}
+
+/*
+ * hud text colour to stand out against a background colour
+ */
+static inline uint16_t tmsHudColour(uint8_t bgIndex)
+{
+  // light backgrounds (yellows, cyan, grey, white) get black text
+  const uint16_t lightBgs = (1 << 3) | (1 << 7) | (1 << 9) | (1 << 10) | (1 << 11) | (1 << 14) | (1 << 15);
+  return tmsPal[(lightBgs & (1 << bgIndex)) ? 1 : 15];
+}
+
+/*
+ * retag the margin cache for buffers the helper filled (core1)
+ */
+static void __time_critical_func(tmsTakeHelperResults)()
+{
+  uint32_t head = helperResultHead;
+  __dmb();
+
+  for (uint32_t tail = helperResultTail; tail != head; ++tail)
+  {
+    const TmsHelperResult* result = &helperResults[tail & (TMS_HELPER_RESULTS - 1)];
+    for (int i = 0; i < TMS_MARGIN_CACHE; ++i)
+    {
+      if (tmsMarginBuffers[i] == result->pixels)
+      {
+        tmsMarginBg[i] = result->bg;
+        break;
+      }
+    }
+  }
+
+  __dmb();
+  helperResultTail = head;
+}
+
+static void tmsApplyRasterWrites(uint16_t y);
+
+/*
+ * vga scanline callback for tms9918
+ */
+static void __time_critical_func(tmsScanline)(uint16_t y, VgaParams* params, uint16_t* pixels)
+{
+  const uint32_t vBorder = (params->vVirtualPixels - TMS9918_PIXELS_Y) / 2;
+  const uint32_t hBorder = (params->hVirtualPixels - TMS9918_PIXELS_X) / 2;
+  const bool oddBorder = hBorder & 1;   // the line straddles 32-bit words
+
+  VrEmuTms9918* vdp = renderTms;
+
+  if (helperResultTail != helperResultHead)
+  {
+    tmsTakeHelperResults();
+  }
+
+  // register writes due by this line
+  if (rasterNext != rasterCount && y >= vBorder)
+  {
+    tmsApplyRasterWrites(y - vBorder);
+  }
+
+  uint32_t bgIndex = vrEmuTms9918RegValue(vdp, TMS_REG_FG_BG_COLOR) & 0x0f;
+  uint16_t bg = tmsPal[bgIndex];
+  uint32_t bg2 = bg | (bg << 16);
+  uint32_t* dst = (uint32_t*)pixels;
+
+  // top or bottom border
+  if (y < vBorder || y >= (vBorder + TMS9918_PIXELS_Y))
+  {
+    for (int x = 0; x < params->hVirtualPixels / 2; ++x)
+    {
+      dst[x] = bg2;
+    }
+    pixels[params->hVirtualPixels - 1] = bg;
+
+    if (y < HUD_ROWS && hudVisible())
+    {
+      hudDrawRow(y, pixels, tmsHudColour(bgIndex));
+
+      // the text covers this buffer's margins
+      for (int i = 0; i < TMS_MARGIN_CACHE; ++i)
+      {
+        if (tmsMarginBuffers[i] == pixels) tmsMarginBuffers[i] = NULL;
+      }
+    }
+    return;
+  }
+
+  y -= vBorder;
+
+  // left and right borders only change with the background colour
+  bool marginsValid = false;
+  for (int i = 0; i < TMS_MARGIN_CACHE; ++i)
+  {
+    if (tmsMarginBuffers[i] == pixels)
+    {
+      marginsValid = (tmsMarginBg[i] == bg);
+      tmsMarginBg[i] = bg;
+      break;
+    }
+    if (i == TMS_MARGIN_CACHE - 1)
+    {
+      tmsMarginBuffers[tmsMarginNext] = pixels;
+      tmsMarginBg[tmsMarginNext] = bg;
+      tmsMarginNext = (tmsMarginNext + 1) % TMS_MARGIN_CACHE;
+    }
+  }
+
+  // left border
+  if (!marginsValid)
+  {
+    for (int x = 0; x < hBorder / 2; ++x)
+    {
+      dst[x] = bg2;
+    }
+  }
+  dst += hBorder / 2;
+
+#if TMS9918_INTERP_PALETTE
+  static bool interpReady = false;
+  if (!interpReady)
+  {
+    tmsInitInterp();    // interpolators are per-core. this is core1's
+    interpReady = true;
+  }
+#endif
+
+  // unchanged line? expand it from the cache (along with any sprite status
+  // it raised). the interrupt line always goes to the vdp
+  uint8_t* packed = tmsLineCache ? (tmsLineCache + y * TMS_PACKED_LINE_BYTES) : tmsPackedScratch;
+  if (tmsLineCache && !tmsLineDirty[y] && y != TMS9918_PIXELS_Y - 1)
+  {
+    tmsExpandLine(packed, dst, oddBorder, bgIndex);
+    if (tmsLineStatus[y]) tmsMergeStatus(tmsLineStatus[y]);
+  }
+  else
+  {
+    tmsRenderLine(vdp, y, packed, dst, oddBorder, bgIndex);
+  }
+
+  // right border
+  if (!marginsValid)
+  {
+    for (int x = hBorder + TMS9918_PIXELS_X + oddBorder; x < params->hVirtualPixels; ++x)
+    {
+      pixels[x] = bg;
+    }
+  }
+
+  if (y == TMS9918_PIXELS_Y - 1)
+  {
+    ++vblankCount;
+  }
+
+  // interrupt? (enabled in the working vdp. the render vdp can be a frame behind)
+  if (scanlineIrqEnabled && y == TMS9918_PIXELS_Y - 1)
+  {
+    if ((vrEmuTms9918RegValue(tms, TMS_REG_1) & 0x20))
+    {
+      raiseInterrupt(1);
+    }
+  }
+}
+
+
+/*
+ * can core0 render line y right now? (vga helper filter, called under the
+ * vga render lock). only cached lines in the display area of a
+ * double-buffered frame with no raster writes, and only while there's room
+ * to pass the margin colour back. the interrupt line stays with core1
+ */
+static bool __time_critical_func(tmsHelperFilter)(uint16_t y, VgaParams* params)
+{
+  if (renderTms == tms || !tmsLineCache || rasterCount) return false;
+  if (helperResultHead - helperResultTail >= TMS_HELPER_RESULTS) return false;
+
+  const uint32_t vBorder = (params->vVirtualPixels - TMS9918_PIXELS_Y) / 2;
+  if (y < vBorder || y >= (vBorder + TMS9918_PIXELS_Y - 1)) return false;
+
+  return !tmsLineDirty[y - vBorder];
+}
+
+/*
+ * vga scanline callback for tms9918 on core0 (for lines tmsHelperFilter accepts)
+ */
+static void __time_critical_func(tmsHelperScanline)(uint16_t y, VgaParams* params, uint16_t* pixels)
+{
+  const uint32_t vBorder = (params->vVirtualPixels - TMS9918_PIXELS_Y) / 2;
+  const uint32_t hBorder = (params->hVirtualPixels - TMS9918_PIXELS_X) / 2;
+  const bool oddBorder = hBorder & 1;
+
+  VrEmuTms9918* vdp = renderTms;
+
+  uint32_t bgIndex = vrEmuTms9918RegValue(vdp, TMS_REG_FG_BG_COLOR) & 0x0f;
+  uint16_t bg = tmsPal[bgIndex];
+  uint32_t bg2 = bg | (bg << 16);
+  uint32_t* dst = (uint32_t*)pixels;
+
+  y -= vBorder;
+
+  // borders. the margin cache belongs to core1, so always fill them (with
+  // the same colour core1 would use - it can't change mid-frame here) and
+  // tell core1 what this buffer's margins now hold
+  for (int x = 0; x < hBorder / 2; ++x)
+  {
+    dst[x] = bg2;
+  }
+  for (int x = hBorder + TMS9918_PIXELS_X + oddBorder; x < params->hVirtualPixels; ++x)
+  {
+    pixels[x] = bg;
+  }
+  dst += hBorder / 2;
+
+#if TMS9918_INTERP_PALETTE
+  static bool interpReady = false;
+  if (!interpReady)
+  {
+    tmsInitInterp();    // this is core0's
+    interpReady = true;
+  }
+#endif
+
+  // the filter only passes cached lines
+  tmsExpandLine(tmsLineCache + y * TMS_PACKED_LINE_BYTES, dst, oddBorder, bgIndex);
+  if (tmsLineStatus[y]) tmsMergeStatus(tmsLineStatus[y]);
+
+  // the filter made sure there's room
+  uint32_t head = helperResultHead;
+  TmsHelperResult* result = &helperResults[head & (TMS_HELPER_RESULTS - 1)];
+  result->pixels = pixels;
+  result->bg = bg;
+  __dmb();
+  helperResultHead = head + 1;
+}
+
+/*
+ * vga scanline source callback for tms9918
+ *  - border lines are sent straight from a cached line
+ */
+static const uint16_t* __time_critical_func(tmsScanlineSource)(uint16_t y, VgaParams* params)
+{
+  const uint32_t vBorder = (params->vVirtualPixels - TMS9918_PIXELS_Y) / 2;
+  if (y >= vBorder && y < (vBorder + TMS9918_PIXELS_Y))
+  {
+    return NULL;
+  }
+
+  // hud rows are drawn by tmsScanline
+  if (y < HUD_ROWS && hudVisible())
+  {
+    return NULL;
+  }
+
+  uint16_t bg = tmsPal[vrEmuTms9918RegValue(renderTms, TMS_REG_FG_BG_COLOR) & 0x0f];
+  if (bg != tmsBorderLineBg)
+  {
+    // rebuild in the other buffer. the current one might still be on screen
+    tmsBorderLineIndex ^= 1;
+    uint16_t* line = tmsBorderLines[tmsBorderLineIndex];
+    for (int x = 0; x < params->hVirtualPixels; ++x)
+    {
+      line[x] = bg;
+    }
+    tmsBorderLineBg = bg;
+  }
+
+  return tmsBorderLines[tmsBorderLineIndex];
+}
+
+/*
+ * set callback for end of frame events
+ */
+void tmsSetFrameCallback(vgaEndOfFrameFn cb)
+{
+  eofCallback = cb;
+}
+
+/*
+ * set callback for end of scanline events
+ */
+void tmsSetHsyncCallback(vgaEndOfScanlineFn cb)
+{
+  scanlineCallback = cb;
+}
+
+/*
+ * enable/disable raising the vdp interrupt from the renderer. when disabled,
+ * the caller is responsible for raising it (eg. from emulated cpu time)
+ */
+void tmsSetScanlineInterrupt(bool enabled)
+{
+  scanlineIrqEnabled = enabled;
+}
+
+/*
+ * get vga horizontal frequency in Hz
+ */
+int tmsGetHsyncFreq()
+{
+  return vgaCurrentParams().params.hSyncParams.freqHz;
+}
+
+/*
+ * get vga vertical frequency in Hz
+ */
+float tmsGetVsyncFreq()
+{
+  return vgaCurrentParams().params.vSyncParams.freqHz;
+}
+
+/*
+ * log a decoded write (core0)
+ */
+static inline void logWrite(uint32_t entry)
+{
+  uint32_t head = writeLogHead;
+  if (head - writeLogTail >= TMS_WRITE_LOG_SIZE)
+  {
+    ++writeLogDrops;    // core1 will resync everything
+    return;
+  }
+
+  writeLog[head & (TMS_WRITE_LOG_SIZE - 1)] = entry;
+  __dmb();
+  writeLogHead = head + 1;
+}
+
+/*
+ * update vram table layout of the render vdp (core1)
+ */
+static void tmsUpdateLayout()
+{
+  TmsLayout* l = &tmsLayout;
+  l->mode = vrEmuTms9918DisplayMode(renderTms);
+  l->nameAddr = (vrEmuTms9918RegValue(renderTms, TMS_REG_NAME_TABLE) & 0x0f) << 10;
+  l->nameCols = (l->mode == TMS_MODE_TEXT) ? 40 : 32;
+  l->nameSize = l->nameCols * 24;
+  l->colorSize = 0;
+  l->spritePattAddr = (vrEmuTms9918RegValue(renderTms, TMS_REG_SPRITE_PATT_TABLE) & 0x07) << 11;
+
+  if (l->mode == TMS_MODE_GRAPHICS_II)
+  {
+    l->pattAddr = (vrEmuTms9918RegValue(renderTms, TMS_REG_PATTERN_TABLE) & 0x04) << 11;
+    l->pattSize = 0x1800;
+    l->colorAddr = (vrEmuTms9918RegValue(renderTms, TMS_REG_COLOR_TABLE) & 0x80) << 6;
+    l->colorSize = 0x1800;
+  }
+  else
+  {
+    l->pattAddr = (vrEmuTms9918RegValue(renderTms, TMS_REG_PATTERN_TABLE) & 0x07) << 11;
+    l->pattSize = 0x800;
+    if (l->mode == TMS_MODE_GRAPHICS_I)
+    {
+      l->colorAddr = vrEmuTms9918RegValue(renderTms, TMS_REG_COLOR_TABLE) << 6;
+      l->colorSize = 32;
+    }
+  }
+}
+
+/*
+ * mark every line dirty (core1)
+ */
+static inline void tmsMarkAllDirty()
+{
+  memset(tmsLineDirty, true, sizeof(tmsLineDirty));
+}
+
+/*
+ * mark lines showing a given pixel row of each tile dirty (core1)
+ */
+static inline void tmsMarkPixelRowDirty(int row)
+{
+  for (int y = row; y < TMS9918_PIXELS_Y; y += 8)
+  {
+    tmsLineDirty[y] = true;
+  }
+}
+
+/*
+ * mark lines affected by a vram write dirty (core1)
+ *  - sprite attributes are compared when the sprite lines are built
+ */
+static void tmsMarkVramDirty(uint16_t addr)
+{
+  const TmsLayout* l = &tmsLayout;
+
+  if ((uint16_t)(addr - l->spritePattAddr) < 0x800)
+  {
+    tmsSpritePattsDirty = true;
+  }
+
+  uint16_t offset = addr - l->nameAddr;
+  if (offset < l->nameSize)
+  {
+    int y = (offset / l->nameCols) * 8;
+    memset(tmsLineDirty + y, true, 8);
+  }
+
+  offset = addr - l->pattAddr;
+  if (offset < l->pattSize)
+  {
+    if (l->mode == TMS_MODE_MULTICOLOR)
+    {
+      tmsMarkAllDirty();
+    }
+    else
+    {
+      tmsMarkPixelRowDirty(offset & 0x07);
+    }
+  }
+
+  offset = addr - l->colorAddr;
+  if (offset < l->colorSize)
+  {
+    if (l->mode == TMS_MODE_GRAPHICS_II)
+    {
+      tmsMarkPixelRowDirty(offset & 0x07);
+    }
+    else
+    {
+      tmsMarkAllDirty();
+    }
+  }
+}
+
+/*
+ * list the sprites of a vdp and the visible sprites on each line. returns
+ * the number of sprites (before the terminator)
+ */
+static int tmsListSprites(VrEmuTms9918* vdp, TmsSprite* sprites, TmsSpriteLine* lines)
+{
+  memset(lines, 0, TMS9918_PIXELS_Y * sizeof(TmsSpriteLine));
+
+  if (vrEmuTms9918DisplayMode(vdp) == TMS_MODE_TEXT) return 0;
+
+  uint8_t reg1 = vrEmuTms9918RegValue(vdp, TMS_REG_1);
+  int size = ((reg1 & 0x02) ? 16 : 8) << (reg1 & 0x01);
+  uint16_t attrAddr = (vrEmuTms9918RegValue(vdp, TMS_REG_SPRITE_ATTR_TABLE) & 0x7f) << 7;
+
+  int count = 0;
+  for (; count < TMS_MAX_SPRITES; ++count)
+  {
+    uint16_t addr = attrAddr + count * 4;
+    int spriteY = vrEmuTms9918VramValue(vdp, addr);
+    if (spriteY == TMS_SPRITE_TERMINATOR) break;
+
+    spriteY = (spriteY + 1) & 0xff;
+    if (spriteY > 0xe0) spriteY -= 256;
+
+    uint8_t colour = vrEmuTms9918VramValue(vdp, addr + 3);
+    TmsSprite* sprite = &sprites[count];
+    sprite->y = spriteY;
+    sprite->x = vrEmuTms9918VramValue(vdp, addr + 1) - ((colour & TMS_SPRITE_EARLY_CLOCK) ? 32 : 0);
+    sprite->name = vrEmuTms9918VramValue(vdp, addr + 2);
+    sprite->colour = colour & 0x0f;
+
+    int endY = spriteY + size;
+    if (endY > TMS9918_PIXELS_Y) endY = TMS9918_PIXELS_Y;
+    for (int y = (spriteY < 0) ? 0 : spriteY; y < endY; ++y)
+    {
+      TmsSpriteLine* line = &lines[y];
+      if (line->count < TMS_MAX_LINE_SPRITES)
+      {
+        line->sprites[line->count++] = count;
+      }
+      else if (line->count == TMS_MAX_LINE_SPRITES)
+      {
+        line->fifth = count;
+        ++line->count;
+      }
+    }
+  }
+  return count;
+}
+
+/*
+ * a sprite's pixels on line y. the msb is the left pixel (magnified if
+ * reg1 says so). the pattern table is at pattAddr
+ */
+static uint32_t __time_critical_func(tmsSpriteRowBits)(VrEmuTms9918* vdp, const TmsSprite* sprite, int y, uint8_t reg1, uint16_t pattAddr)
+{
+  const bool size16 = reg1 & 0x02;
+  const int mag = reg1 & 0x01;
+
+  uint16_t addr = pattAddr + (size16 ? (sprite->name & 0xfc) : sprite->name) * 8 + ((y - sprite->y) >> mag);
+  uint32_t bits = vrEmuTms9918VramValue(vdp, addr) << 24;
+  if (size16) bits |= vrEmuTms9918VramValue(vdp, addr + 16) << 16;
+
+  if (mag)
+  {
+    // each pattern bit becomes two pixels
+    uint32_t doubled = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+      if (bits & (0x80000000u >> i)) doubled |= 0xc0000000u >> (i * 2);
+    }
+    bits = doubled;
+  }
+  return bits;
+}
+
+/*
+ * add a sprite's pixels (msb at x) to a line of sprite pixels (one bit per
+ * pixel, msb on the left). returns true if any were already set
+ */
+static bool __time_critical_func(tmsSpritePlace)(uint32_t* line, int x, uint32_t bits)
+{
+  if (x < 0)
+  {
+    if (x <= -32) return false;
+    bits <<= -x;
+    x = 0;
+  }
+  if (!bits || x >= TMS9918_PIXELS_X) return false;
+
+  const int word = x >> 5;
+  const int shift = x & 31;
+  const uint32_t left = bits >> shift;
+  const uint32_t right = shift ? (bits << (32 - shift)) : 0;
+  const bool rightOnScreen = (word + 1) < (TMS9918_PIXELS_X / 32);
+
+  bool collision = (line[word] & left) || (rightOnScreen && (line[word + 1] & right));
+  line[word] |= left;
+  if (rightOnScreen) line[word + 1] |= right;
+  return collision;
+}
+
+/*
+ * sprite status flags (collision, fifth sprite and its number) for a whole
+ * frame of the working vdp, from its current vram and registers (core0).
+ * for when the status has to follow emulated time rather than the renderer
+ */
+uint8_t tmsSpriteStatus()
+{
+  static TmsSprite sprites[TMS_MAX_SPRITES];
+  static TmsSpriteLine lines[TMS9918_PIXELS_Y];
+
+  // a blanked display doesn't process sprites
+  uint8_t reg1 = vrEmuTms9918RegValue(tms, TMS_REG_1);
+  if (!(reg1 & 0x40) || !tmsListSprites(tms, sprites, lines)) return 0;
+
+  uint16_t pattAddr = (vrEmuTms9918RegValue(tms, TMS_REG_SPRITE_PATT_TABLE) & 0x07) << 11;
+
+  uint8_t status = 0;
+  for (int y = 0; y < TMS9918_PIXELS_Y; ++y)
+  {
+    const TmsSpriteLine* line = &lines[y];
+    if (line->count > TMS_MAX_LINE_SPRITES && !(status & TMS_STATUS_5S))
+    {
+      status |= TMS_STATUS_5S | line->fifth;
+    }
+
+    // only the four displayed sprites collide
+    if (line->count < 2 || (status & TMS_STATUS_COL)) continue;
+
+    uint32_t pixels[TMS9918_PIXELS_X / 32] = { 0 };
+    int visible = line->count > TMS_MAX_LINE_SPRITES ? TMS_MAX_LINE_SPRITES : line->count;
+    for (int i = 0; i < visible; ++i)
+    {
+      const TmsSprite* sprite = &sprites[line->sprites[i]];
+      if (tmsSpritePlace(pixels, sprite->x, tmsSpriteRowBits(tms, sprite, y, reg1, pattAddr)))
+      {
+        status |= TMS_STATUS_COL;
+        break;
+      }
+    }
+  }
+  return status;
+}
+
+/*
+ * build the list of visible sprites for each line (core1)
+ *  - lines whose sprites changed since last frame are marked dirty
+ */
+static void tmsBuildSpriteLines()
+{
+  uint32_t spriteHash[TMS_MAX_SPRITES];
+
+  int count = tmsListSprites(renderTms, tmsSprites, tmsSpriteLines);
+  tmsSpriteLinesStale = false;
+
+  // hash of each sprite's number and attributes
+  for (int i = 0; i < count; ++i)
+  {
+    const TmsSprite* sprite = &tmsSprites[i];
+    uint32_t hash = 2166136261u ^ i;
+    hash = (hash ^ (uint16_t)sprite->y) * 16777619u;
+    hash = (hash ^ (uint16_t)sprite->x) * 16777619u;
+    hash = (hash ^ sprite->name) * 16777619u;
+    spriteHash[i] = (hash ^ sprite->colour) * 16777619u;
+  }
+
+  // compare each line's sprites with last frame
+  for (int y = 0; y < TMS9918_PIXELS_Y; ++y)
+  {
+    const TmsSpriteLine* line = &tmsSpriteLines[y];
+    uint32_t signature = 0;
+    if (line->count)
+    {
+      signature = line->count;
+      int visible = line->count > TMS_MAX_LINE_SPRITES ? TMS_MAX_LINE_SPRITES : line->count;
+      for (int i = 0; i < visible; ++i)
+      {
+        signature = (signature * 16777619u) ^ spriteHash[line->sprites[i]];
+      }
+      if (visible < line->count)
+      {
+        signature = (signature * 16777619u) ^ line->fifth;
+      }
+      if (!signature) signature = 1;
+    }
+
+    if (signature != tmsSpriteSignature[y] || (signature && tmsSpritePattsDirty))
+    {
+      tmsLineDirty[y] = true;
+    }
+    tmsSpriteSignature[y] = signature;
+  }
+
+  tmsSpritePattsDirty = false;
+}
+
+/*
+ * start copying the working vdp to the render vdp. the working vdp is
+ * rendered until the copy is complete (core1)
+ */
+static void startResync()
+{
+  renderTms = tms;
+  tmsLineCache = NULL;
+  rasterCount = rasterNext = 0;
+  renderAddr = TMS_RENDER_ADDR_UNKNOWN;
+
+  syncedDrops = writeLogDrops;
+  memset(resyncPages, 0xff, sizeof(resyncPages));
+  resyncing = true;
+}
+
+/*
+ * copy the next few pages of the vram shadow to the render vdp. once every
+ * page is copied, switch to rendering it (core1)
+ */
+static void continueResync()
+{
+  // anything dropped: start over
+  uint32_t drops = writeLogDrops;
+  if (drops != syncedDrops)
+  {
+    syncedDrops = drops;
+    memset(resyncPages, 0xff, sizeof(resyncPages));
+  }
+
+  // pages written since they were copied need copying again
+  uint32_t head = writeLogHead;
+  __dmb();
+
+  for (uint32_t tail = writeLogTail; tail != head; ++tail)
+  {
+    uint32_t entry = writeLog[tail & (TMS_WRITE_LOG_SIZE - 1)];
+    if (!(entry & TMS_WRITE_LOG_REG))
+    {
+      uint32_t page = (entry >> 8) / TMS_VRAM_PAGE_BYTES;
+      resyncPages[page / 32] |= 1u << (page & 31);
+    }
+  }
+  writeLogTail = head;
+
+  int copied = 0;
+  bool remaining = false;
+  for (int page = 0; page < TMS_VRAM_PAGES; ++page)
+  {
+    if (!(resyncPages[page / 32] & (1u << (page & 31)))) continue;
+
+    if (copied == TMS_RESYNC_PAGES)
+    {
+      remaining = true;
+      break;
+    }
+
+    resyncPages[page / 32] &= ~(1u << (page & 31));
+    vrEmuTms9918SetAddressWrite(tmsRenderInstance, page * TMS_VRAM_PAGE_BYTES);
+    vrEmuTms9918WriteBytes(tmsRenderInstance, vramShadow + page * TMS_VRAM_PAGE_BYTES, TMS_VRAM_PAGE_BYTES);
+    ++copied;
+  }
+
+  if (remaining) return;
+
+  // registers logged after this are replayed next frame
+  for (int i = 0; i < TMS_NUM_REGISTERS; ++i)
+  {
+    vrEmuTms9918WriteRegValue(tmsRenderInstance, i, vrEmuTms9918RegValue(tms, i));
+  }
+
+  resyncing = false;
+  renderTms = tmsRenderInstance;
+  tmsLineCache = tmsLineCacheAlloc;
+
+  tmsUpdateLayout();
+  tmsMarkAllDirty();
+}
+
+/*
+ * write a render vdp register (core1)
+ */
+static void tmsApplyRegister(uint8_t reg, uint8_t value)
+{
+  vrEmuTms9918WriteRegValue(renderTms, reg, value);
+
+  // mode, size or sprite tables changed mid-frame. this frame's sprite
+  // lines go back to the full scanline
+  if (reg <= TMS_REG_1 || reg == TMS_REG_SPRITE_ATTR_TABLE || reg == TMS_REG_SPRITE_PATT_TABLE)
+  {
+    tmsSpriteLinesStale = true;
+  }
+
+  tmsUpdateLayout();
+  tmsMarkAllDirty();
+}
+
+/*
+ * apply queued raster writes due by line y (core1)
+ */
+static void __time_critical_func(tmsApplyRasterWrites)(uint16_t y)
+{
+  uint32_t count = rasterCount;
+  while (rasterNext != count && rasterQueue[rasterNext].line <= y)
+  {
+    tmsApplyRegister(rasterQueue[rasterNext].reg, rasterQueue[rasterNext].value);
+    ++rasterNext;
+  }
+}
+
+/*
+ * apply all queued raster writes (core1)
+ */
+static void tmsFlushRasterWrites()
+{
+  tmsApplyRasterWrites(TMS_LINE_NONE);
+  rasterCount = rasterNext = 0;
+}
+
+/*
+ * queue a logged register write for its line, or apply it now (core1)
+ */
+static void tmsReplayRegister(uint16_t line, uint8_t reg, uint8_t value)
+{
+  if (line >= TMS9918_PIXELS_Y)
+  {
+    // during vblank. before any display writes, it applies from the top
+    // of the frame. after them, once the display is done
+    if (rasterCount == 0)
+    {
+      tmsApplyRegister(reg, value);
+      return;
+    }
+    line = TMS9918_PIXELS_Y;
+  }
+  else if (rasterCount && line < rasterQueue[rasterCount - 1].line)
+  {
+    // back up the screen. this is the next emulated frame
+    tmsFlushRasterWrites();
+  }
+
+  if (rasterCount == TMS_RASTER_QUEUE_SIZE)
+  {
+    tmsFlushRasterWrites();
+  }
+
+  rasterQueue[rasterCount].line = line;
+  rasterQueue[rasterCount].reg = reg;
+  rasterQueue[rasterCount].value = value;
+  ++rasterCount;
+}
+
+/*
+ * replay this frame's writes to the render vdp (core1)
+ */
+static void syncRenderVdp()
+{
+  // whatever the last frame didn't reach
+  tmsFlushRasterWrites();
+
+  if (syncedDrops != writeLogDrops)
+  {
+    startResync();
+    continueResync();
+    return;
+  }
+
+  uint32_t tail = writeLogTail;
+  uint32_t head = writeLogHead;
+  __dmb();
+
+  // the rest waits for the next frame
+  if (head - tail > TMS_SYNC_MAX_ENTRIES)
+  {
+    head = tail + TMS_SYNC_MAX_ENTRIES;
+  }
+
+  for (; tail != head; ++tail)
+  {
+    uint32_t entry = writeLog[tail & (TMS_WRITE_LOG_SIZE - 1)];
+    if (entry & TMS_WRITE_LOG_REG)
+    {
+      uint16_t line = (entry >> TMS_WRITE_LOG_LINE_SHIFT) & TMS_WRITE_LOG_LINE_MASK;
+      tmsReplayRegister(line, (entry >> 8) & 0x07, entry & 0xff);
+    }
+    else
+    {
+      uint16_t addr = entry >> 8;
+      if (addr != renderAddr)
+      {
+        vrEmuTms9918SetAddressWrite(renderTms, addr);
+      }
+      vrEmuTms9918WriteData(renderTms, entry & 0xff);
+      renderAddr = (addr + 1) & (TMS9918_VRAM_SIZE - 1);
+      tmsMarkVramDirty(addr);
+    }
+  }
+  writeLogTail = head;
+}
+
+/*
+ * vga end-of-frame callback for tms9918
+ */
+static void tmsEndOfFrame(uint64_t frameNumber)
+{
+  if (doubleBufferRequested)
+  {
+    // the helper is idle now
+    tmsTakeHelperResults();
+
+    if (resyncing)
+    {
+      continueResync();
+    }
+    else if (renderTms == tms)
+    {
+      startResync();
+      continueResync();
+    }
+    else
+    {
+      syncRenderVdp();
+    }
+
+    if (tmsLineCache)
+    {
+      tmsBuildSpriteLines();
+    }
+  }
+
+  if (eofCallback) eofCallback(frameNumber);
+}
+
+/*
+ * write to the vdp address/register port
+ */
+void __not_in_flash_func(tmsWriteAddr)(uint8_t value)
+{
+  vrEmuTms9918WriteAddr(tms, value);
+  if (!vramShadow) return;
+
+  if (!addrStage)
+  {
+    addrLatch = value;
+    addrStage = true;
+    return;
+  }
+
+  addrStage = false;
+  if (value & 0x80)
+  {
+    if (!logWrites) return;
+    uint32_t line = writeLine < TMS_LINE_NONE ? writeLine : TMS_WRITE_LOG_LINE_MASK;
+    logWrite(TMS_WRITE_LOG_REG | (line << TMS_WRITE_LOG_LINE_SHIFT) | ((value & 0x07) << 8) | addrLatch);
+  }
+  else
+  {
+    vramAddr = ((value & 0x3f) << 8) | addrLatch;
+    if (!(value & 0x40)) ++vramAddr;    // read setup pre-fetches
+    vramAddr &= TMS9918_VRAM_SIZE - 1;
+  }
+}
+
+/*
+ * emulated scanline of the following register writes (core0). 0 is the first
+ * display line, TMS_LINE_NONE applies them from the start of the frame
+ */
+void tmsSetWriteLine(uint16_t line)
+{
+  writeLine = line;
+}
+
+/*
+ * number of frames core1 has finished the display for (the vdp interrupt
+ * point, whether or not the interrupt is enabled)
+ */
+uint32_t tmsVblankCount()
+{
+  return vblankCount;
+}
+
+/*
+ * write to the vdp data port
+ */
+void __not_in_flash_func(tmsWriteData)(uint8_t value)
+{
+  vrEmuTms9918WriteData(tms, value);
+  if (!vramShadow) return;
+
+  addrStage = false;
+  vramShadow[vramAddr] = value;
+  vramWrittenPages[vramAddr / (TMS_VRAM_PAGE_BYTES * 32)] |= 1u << ((vramAddr / TMS_VRAM_PAGE_BYTES) & 31);
+  if (logWrites) logWrite((vramAddr << 8) | value);
+  vramAddr = (vramAddr + 1) & (TMS9918_VRAM_SIZE - 1);
+}
+
+/*
+ * read from the vdp data port
+ */
+uint8_t __not_in_flash_func(tmsReadData)()
+{
+  addrStage = false;
+  vramAddr = (vramAddr + 1) & (TMS9918_VRAM_SIZE - 1);
+  return vrEmuTms9918ReadData(tms);
+}
+
+/*
+ * read the vdp status register
+ */
+uint8_t __not_in_flash_func(tmsReadStatus)()
+{
+  addrStage = false;
+  uint8_t value = vrEmuTms9918ReadStatus(tms);
+
+  if (renderTms != tms)
+  {
+    // flags are raised by the render vdp
+    uint32_t save = spin_lock_blocking(statusLock);
+    value = renderStatus;
+    renderStatus = 0;
+    spin_unlock(statusLock, save);
+  }
+  return value;
+}
+
+/*
+ * render from a copy of vram updated once per frame (tear-free). call from
+ * core0 once the vdp is only accessed through the tmsXxx() functions above
+ */
+void tmsEnableDoubleBuffer()
+{
+  if (logWrites || !tmsEnableShadow()) return;
+
+  tmsRenderInstance = vrEmuTms9918New();
+  if (!tmsRenderInstance) return;
+
+  statusLock = spin_lock_init(spin_lock_claim_unused(true));
+
+  // optional line cache (core1 takes it when it switches to the render vdp)
+  tmsLineCacheAlloc = malloc(TMS9918_PIXELS_Y * TMS_PACKED_LINE_BYTES);
+
+  logWrites = true;
+  tmsWriteAddr(0);
+  tmsWriteAddr(0x40);
+
+  doubleBufferRequested = true;
+}
+
+/*
+ * keep a shadow copy of vram (and the address register) on core0. call from
+ * core0 once the vdp is only accessed through the tmsXxx() functions above
+ */
+bool tmsEnableShadow()
+{
+  if (vramShadow) return true;
+
+  vramShadow = malloc(TMS9918_VRAM_SIZE);
+  if (!vramShadow) return false;
+
+  for (int i = 0; i < TMS9918_VRAM_SIZE; ++i)
+  {
+    vramShadow[i] = vrEmuTms9918VramValue(tms, i);
+  }
+  memset(vramWrittenPages, 0xff, sizeof(vramWrittenPages));
+
+  // the vdp address register isn't visible, so start from a known address
+  tmsWriteAddr(0);
+  tmsWriteAddr(0x40);
+  return true;
+}
+
+/*
+ * the vram shadow (NULL until tmsEnableShadow)
+ */
+const uint8_t* tmsVramShadow()
+{
+  return vramShadow;
+}
+
+/*
+ * written flags for each vram page (TMS_VRAM_PAGE_BYTES), one bit per page.
+ * set by tmsWriteData, cleared by the caller
+ */
+uint32_t* tmsVramWrittenPages()
+{
+  return vramWrittenPages;
+}
+
+/*
+ * bring vram back to a saved copy. only bytes that differ from the shadow
+ * are written (through the data port, so the render vdp sees them too)
+ */
+void tmsRestoreVram(const uint8_t* vram)
+{
+  if (!vramShadow) return;
+
+  for (int page = 0; page < TMS9918_VRAM_SIZE; page += TMS_VRAM_PAGE_BYTES)
+  {
+    if (memcmp(vram + page, vramShadow + page, TMS_VRAM_PAGE_BYTES) == 0) continue;
+
+    for (int addr = page; addr < page + TMS_VRAM_PAGE_BYTES; ++addr)
+    {
+      if (vram[addr] == vramShadow[addr]) continue;
+
+      if (addr != vramAddr)
+      {
+        tmsWriteAddr(addr & 0xff);
+        tmsWriteAddr(0x40 | (addr >> 8));
+      }
+      tmsWriteData(vram[addr]);
+    }
+  }
+}
+
+/*
+ * the vdp port state: address register, first byte latch and (when double
+ * buffered) the pending status flags. requires the shadow
+ */
+uint32_t tmsPortState()
+{
+  uint32_t status = 0;
+  if (renderTms != tms)
+  {
+    uint32_t save = spin_lock_blocking(statusLock);
+    status = renderStatus;
+    spin_unlock(statusLock, save);
+  }
+
+  return vramAddr | (addrStage ? TMS_PORT_STAGE : 0) |
+    (addrLatch << TMS_PORT_LATCH_SHIFT) | (status << TMS_PORT_STATUS_SHIFT);
+}
+
+/*
+ * restore the vdp port state from tmsPortState()
+ *  - the read-ahead buffer is reloaded from the byte before the address
+ *    (what it holds after a write)
+ */
+void tmsSetPortState(uint32_t state)
+{
+  uint16_t prev = ((state & TMS_PORT_ADDR_MASK) - 1) & (TMS9918_VRAM_SIZE - 1);
+  tmsWriteAddr(prev & 0xff);
+  tmsWriteAddr((prev >> 8) & 0x3f);   // read setup. pre-fetches, leaving the address
+
+  if (state & TMS_PORT_STAGE)
+  {
+    tmsWriteAddr((state >> TMS_PORT_LATCH_SHIFT) & 0xff);
+  }
+
+  if (renderTms != tms)
+  {
+    uint32_t save = spin_lock_blocking(statusLock);
+    renderStatus = state >> TMS_PORT_STATUS_SHIFT;
+    spin_unlock(statusLock, save);
+  }
+}
+
+/*
+ * vga end-of-scanline callback for tms9918
+ */
+static void tmsEndOfScanline()
+{
+  if (scanlineCallback) scanlineCallback();
+}
+
+#if TMS9918_BENCHMARK
+
+/*
+ * cycles taken to run fn (systick, counting down)
+ */
+static uint32_t tmsCycles(void (*fn)(const uint32_t*, uint16_t*, uint32_t*), const uint32_t* src, uint32_t* dst)
+{
+  systick_hw->cvr = 0;
+  uint32_t start = systick_hw->cvr;
+  fn(src, (uint16_t*)tmsPackedScratch, dst);
+  uint32_t end = systick_hw->cvr;
+  return (start - end) & 0x00ffffff;
+}
+
+/*
+ * the original conversion: one palette lookup per pixel (benchmark baseline)
+ */
+static void tmsConvertPixels(const uint32_t* src, uint16_t* packed, uint32_t* dst)
+{
+  const uint8_t* indices = (const uint8_t*)src;
+  uint16_t* pixels = (uint16_t*)dst;
+  for (int x = 0; x < TMS9918_PIXELS_X; ++x)
+  {
+    pixels[x] = tmsPal[indices[x]];
+  }
+}
+
+/*
+ * compare palette conversion methods for a full line (runs on the calling core)
+ */
+static void tmsBenchmark()
+{
+  static uint8_t __aligned(4) src[TMS9918_PIXELS_X];
+  static uint16_t __aligned(4) dst[TMS9918_PIXELS_X];
+  const int runs = 64;
+
+  for (int i = 0; i < TMS9918_PIXELS_X; ++i)
+  {
+    src[i] = rand() & 0x0f;
+  }
+
+  systick_hw->rvr = 0x00ffffff;
+  systick_hw->csr = 0x5;    // enable, processor clock
+
+  tmsInitInterp();
+
+  uint32_t pixelCycles = 0, lutCycles = 0, interpCycles = 0;
+  for (int i = 0; i < runs; ++i)
+  {
+    pixelCycles += tmsCycles(tmsConvertPixels, (const uint32_t*)src, (uint32_t*)dst);
+    lutCycles += tmsCycles(tmsConvertLut, (const uint32_t*)src, (uint32_t*)dst);
+    interpCycles += tmsCycles(tmsConvertInterp, (const uint32_t*)src, (uint32_t*)dst);
+  }
+
+  printf("tms9918 palette conversion (%d px): per pixel %lu cycles, lut %lu cycles, interp %lu cycles\n",
+    TMS9918_PIXELS_X, pixelCycles / runs, lutCycles / runs, interpCycles / runs);
+}
+
+#endif
+
+static const uint32_t MAX_CLOCK = 270000;
+
+/*
+ * select the vga mode (before tmsInit). the mode must have room for the
+ * 256x192 display
+ */
+bool tmsSetVgaMode(VgaMode mode, int pixelScale)
+{
+  VgaParams params = vgaGetParams(mode, pixelScale);
+  if (params.hVirtualPixels < TMS9918_PIXELS_X || params.vVirtualPixels < TMS9918_PIXELS_Y)
+  {
+    return false;
+  }
+
+  tmsVgaMode = mode;
+  tmsPixelScale = pixelScale;
+  return true;
+}
+
+/*
+ * tms9918 initialisation
+ */
+VrEmuTms9918* tmsInit()
+{
+  tms = vrEmuTms9918New();
+  renderTms = tms;
+
+  // build up tms9918 palette optimized for 12-bit vga
+  for (int c = 0; c < 16; ++c)
+  {
+    uint32_t rgba8 = vrEmuTms9918Palette[c];
+    tmsPal[c] = colorFromRgb(
+      (rgba8 & 0xff000000) >> 24,
+      (rgba8 & 0x00ff0000) >> 16,
+      (rgba8 & 0x0000ff00) >> 8);
+  }
+
+  for (int i = 0; i < 256; ++i)
+  {
+    tmsDpal[i] = tmsPal[i & 0x0f] | (tmsPal[(i & 0xf0) >> 4] << 16);
+  }
+
+  VgaInitParams params = { 0 };
+  params.params = vgaGetParams(tmsVgaMode, tmsPixelScale);
+  params.scanlineFn = tmsScanline;
+  params.endOfFrameFn = tmsEndOfFrame;
+  params.endOfScanlineFn = tmsEndOfScanline;
+  params.helperScanlineFn = tmsHelperScanline;
+  params.helperFilterFn = tmsHelperFilter;
+
+  uint32_t minSysClockFreq = vgaMinimumPioClockKHz(&params.params);
+  uint32_t sysClockFreq = minSysClockFreq;
+  while (sysClockFreq + minSysClockFreq < MAX_CLOCK)
+  {
+    sysClockFreq += minSysClockFreq;
+  }
+
+  vgaSetSysClockKHz(sysClockFreq);
+
+#if TMS9918_BENCHMARK
+  tmsBenchmark();
+#endif
+
+  // cached border lines
+  for (int i = 0; i < 2; ++i)
+  {
+    tmsBorderLines[i] = malloc(params.params.hVirtualPixels * sizeof(uint16_t));
+  }
+  if (tmsBorderLines[0] && tmsBorderLines[1])
+  {
+    params.scanlineSourceFn = tmsScanlineSource;
+  }
+
+  vgaInit(params);
+
+  return tms;
+}
+
+VrEmuTms9918* getTms9918()
+{
+  return tms;
+}
+
+/*
+ * tms9918 destruction
+ */
+void tmsDestroy()
+{
+  if (tms)
+  {
+    vrEmuTms9918Destroy(tms);
+    tms = NULL;
+  }
+}
@@ -1,27 +1,74 @@
-/*
- * Project: pico-56 - tms9918
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-#pragma once
-
-#include "vrEmuTms9918.h"
-#include "vga.h"
-
-#include <inttypes.h>
-
-VrEmuTms9918* tmsInit();
-VrEmuTms9918* getTms9918();
-
-void tmsSetFrameCallback(vgaEndOfFrameFn cb);
-void tmsSetHsyncCallback(vgaEndOfScanlineFn cb);
-
-int tmsGetHsyncFreq();
-
+/*
+ * Project: pico-56 - tms9918
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include "vrEmuTms9918.h"
+#include "vga.h"
+#include "vga-modes.h"
+
+#include <inttypes.h>
+
+#ifndef TMS9918_VRAM_SIZE
+#define TMS9918_VRAM_SIZE (1 << 14)
+#endif
+
+#define TMS_LINES_PER_FRAME   262
+#define TMS_LINE_NONE         0xffff    // register writes not tied to a scanline
+
+#define TMS_VRAM_PAGE_BYTES   256       // granularity of tmsVramWrittenPages()
+#define TMS_VRAM_PAGES        (TMS9918_VRAM_SIZE / TMS_VRAM_PAGE_BYTES)
+
+// tmsPortState(): address (14 bits), first address byte pending, latched
+// first byte and (double-buffered) status flags
+#define TMS_PORT_ADDR_MASK    0x3fff
+#define TMS_PORT_STAGE        0x4000
+#define TMS_PORT_LATCH_SHIFT  16
+#define TMS_PORT_STATUS_SHIFT 24
+
+bool tmsSetVgaMode(VgaMode mode, int pixelScale);
+
+VrEmuTms9918* tmsInit();
+VrEmuTms9918* getTms9918();
+
+void tmsSetFrameCallback(vgaEndOfFrameFn cb);
+void tmsSetHsyncCallback(vgaEndOfScanlineFn cb);
+
+void tmsSetScanlineInterrupt(bool enabled);
+
+void tmsEnableDoubleBuffer();
+
+bool tmsEnableShadow();
+const uint8_t* tmsVramShadow();
+uint32_t* tmsVramWrittenPages();
+void tmsRestoreVram(const uint8_t* vram);
+
+uint32_t tmsPortState();
+void tmsSetPortState(uint32_t state);
+
+void tmsWriteAddr(uint8_t value);
+void tmsWriteData(uint8_t value);
+uint8_t tmsReadData();
+uint8_t tmsReadStatus();
+
+/*
+ * sprite status flags (collision, fifth sprite and its number) for a whole
+ * frame of the working vdp, computed from vram now (core0)
+ */
+uint8_t tmsSpriteStatus();
+
+void tmsSetWriteLine(uint16_t line);
+uint32_t tmsVblankCount();
+
+int tmsGetHsyncFreq();
+float tmsGetVsyncFreq();
+
 void tmsDestroy();
\ No newline at end of file
@@ -0,0 +1,312 @@
+/*
+ * Project: pico-56 - vga text console
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "vga-console.h"
+
+#include "pico/stdlib.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+ /*
+  * the font is copied to ram a glyph row at a time, so all of the glyph
+  * bytes a line needs sit together. each glyph byte is then expanded two
+  * pixels at a time through a per-attribute table (4 words per attribute,
+  * 4KB in all) that is rebuilt when the palette changes. a cell is a load,
+  * a glyph byte and four table lookups into the line buffer
+  *
+  * line budgets (cycles per virtual line, v scale 2, as in VgaStats.lineBudget):
+  *
+  *   80 x 30  - 640x480 at 252MHz: 800 * 252000 / 25175 = 8007 per scanline, 16014
+  *   100 x 37 - 800x600 at 240MHz: 1056 * 240000 / 40000 = 6336 per scanline, 12672
+  *
+  * the cell loop is about 40 cycles on the m0+ (ram, counted from the
+  * loads, stores and shifts): ~3200 (20%) and ~4000 (32%) of those
+  * budgets. that's an estimate. ep01-vga-14-console (CONSOLE_800_600 for
+  * 100 x 37) times every line of a full screen and prints the measured
+  * cycles per line against the budget
+  */
+
+/*
+ * rebuild the expansion table for all attributes
+ */
+static void buildLut(VgaConsole* con)
+{
+  for (int attr = 0; attr < 256; ++attr)
+  {
+    uint32_t fg = con->palette[attr & 0x0f];
+    uint32_t bg = con->palette[attr >> 4];
+
+    // two glyph bits. the high bit is the left pixel (the low halfword)
+    con->lut[attr][0] = bg | (bg << 16);
+    con->lut[attr][1] = bg | (fg << 16);
+    con->lut[attr][2] = fg | (bg << 16);
+    con->lut[attr][3] = fg | (fg << 16);
+  }
+}
+
+/*
+ * initialise a console. font is fontChars glyphs, 8 pixels wide (msb on the
+ * left) and fontHeight rows. returns false if out of memory
+ */
+bool consoleInit(VgaConsole* con, uint16_t cols, uint16_t rows, const uint8_t* font, uint16_t fontChars, uint8_t fontHeight)
+{
+  con->cols = cols;
+  con->rows = rows;
+  con->fontHeight = fontHeight;
+  con->cursorX = 0;
+  con->cursorY = 0;
+  con->attr = CONSOLE_ATTR(15, 0);
+  con->cursorVisible = true;
+  con->frames = 0;
+
+  con->cells = malloc(cols * rows * sizeof(uint16_t));
+  con->glyphs = malloc(fontHeight * CONSOLE_CHARS);
+  if (!con->cells || !con->glyphs) return false;
+
+  // transpose the font to glyph rows. missing glyphs are blank
+  memset(con->glyphs, 0, fontHeight * CONSOLE_CHARS);
+  if (fontChars > CONSOLE_CHARS) fontChars = CONSOLE_CHARS;
+  for (int c = 0; c < fontChars; ++c)
+  {
+    for (int row = 0; row < fontHeight; ++row)
+    {
+      con->glyphs[row * CONSOLE_CHARS + c] = font[c * fontHeight + row];
+    }
+  }
+
+  // cga-ish default palette
+  static const uint16_t defaultPalette[CONSOLE_COLOURS] = {
+    0x000, 0xa00, 0x0a0, 0xaa0, 0x00a, 0xa0a, 0x05a, 0xaaa,
+    0x555, 0xf55, 0x5f5, 0xff5, 0x55f, 0xf5f, 0x5ff, 0xfff
+  };
+  consoleSetPalette(con, defaultPalette);
+  consoleClear(con);
+  return true;
+}
+
+/*
+ * set one palette colour
+ */
+void consoleSetColour(VgaConsole* con, uint8_t index, uint16_t colour)
+{
+  con->palette[index & 0x0f] = colour;
+  buildLut(con);
+}
+
+/*
+ * set the whole palette (CONSOLE_COLOURS entries)
+ */
+void consoleSetPalette(VgaConsole* con, const uint16_t* palette)
+{
+  memcpy(con->palette, palette, sizeof(con->palette));
+  buildLut(con);
+}
+
+/*
+ * attribute for printed characters
+ */
+void consoleSetAttr(VgaConsole* con, uint8_t attr)
+{
+  con->attr = attr;
+}
+
+/*
+ * clear the console (with the current attribute) and home the cursor
+ */
+void consoleClear(VgaConsole* con)
+{
+  uint16_t blank = (con->attr << 8) | ' ';
+  for (int i = 0; i < con->cols * con->rows; ++i)
+  {
+    con->cells[i] = blank;
+  }
+  con->cursorX = 0;
+  con->cursorY = 0;
+}
+
+/*
+ * move the cursor
+ */
+void consoleSetCursor(VgaConsole* con, uint16_t x, uint16_t y)
+{
+  con->cursorX = x < con->cols ? x : con->cols - 1;
+  con->cursorY = y < con->rows ? y : con->rows - 1;
+}
+
+/*
+ * show/hide the cursor
+ */
+void consoleShowCursor(VgaConsole* con, bool show)
+{
+  con->cursorVisible = show;
+}
+
+/*
+ * set a cell directly
+ */
+void consoleSetCell(VgaConsole* con, uint16_t x, uint16_t y, uint8_t c, uint8_t attr)
+{
+  if (x >= con->cols || y >= con->rows) return;
+  con->cells[y * con->cols + x] = (attr << 8) | c;
+}
+
+/*
+ * scroll up a row, clearing the bottom row
+ */
+static void scroll(VgaConsole* con)
+{
+  memmove(con->cells, con->cells + con->cols, (con->rows - 1) * con->cols * sizeof(uint16_t));
+
+  uint16_t blank = (con->attr << 8) | ' ';
+  uint16_t* last = con->cells + (con->rows - 1) * con->cols;
+  for (int i = 0; i < con->cols; ++i)
+  {
+    last[i] = blank;
+  }
+}
+
+/*
+ * move to the start of the next line
+ */
+static void newLine(VgaConsole* con)
+{
+  con->cursorX = 0;
+  if (++con->cursorY >= con->rows)
+  {
+    con->cursorY = con->rows - 1;
+    scroll(con);
+  }
+}
+
+/*
+ * print at the cursor. handles \n, \r, \b and \t and scrolls at the bottom
+ */
+void consolePutChar(VgaConsole* con, char c)
+{
+  switch (c)
+  {
+    case '\n':
+      newLine(con);
+      break;
+
+    case '\r':
+      con->cursorX = 0;
+      break;
+
+    case '\b':
+      if (con->cursorX) --con->cursorX;
+      break;
+
+    case '\t':
+      do
+      {
+        consolePutChar(con, ' ');
+      } while (con->cursorX % CONSOLE_TAB_WIDTH);
+      break;
+
+    default:
+      con->cells[con->cursorY * con->cols + con->cursorX] = (con->attr << 8) | (uint8_t)c;
+      if (++con->cursorX >= con->cols)
+      {
+        newLine(con);
+      }
+      break;
+  }
+}
+
+/*
+ * print a string at the cursor
+ */
+void consolePuts(VgaConsole* con, const char* str)
+{
+  while (*str)
+  {
+    consolePutChar(con, *(str++));
+  }
+}
+
+/*
+ * formatted print at the cursor
+ */
+void consolePrintf(VgaConsole* con, const char* fmt, ...)
+{
+  char buffer[256];
+
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buffer, sizeof(buffer), fmt, args);
+  va_end(args);
+
+  consolePuts(con, buffer);
+}
+
+/*
+ * expand one cell (eight pixels) through the table
+ */
+static inline void expandCell(uint32_t* dst, const uint32_t* lut, uint8_t bits)
+{
+  dst[0] = lut[bits >> 6];
+  dst[1] = lut[(bits >> 4) & 0x03];
+  dst[2] = lut[(bits >> 2) & 0x03];
+  dst[3] = lut[bits & 0x03];
+}
+
+/*
+ * render line y (call from a vgaScanlineRgbFn)
+ */
+void __time_critical_func(consoleScanline)(const VgaConsole* con, uint16_t y, uint16_t* pixels)
+{
+  uint16_t row = y / con->fontHeight;
+  uint32_t* dst = (uint32_t*)pixels;
+
+  // lines below the last row (eg. 296 of 300 at 100 x 37) are background
+  if (row >= con->rows)
+  {
+    uint32_t bg = con->lut[con->attr][0];
+    uint32_t* end = dst + con->cols * 4;
+    while (dst < end)
+    {
+      *(dst++) = bg;
+    }
+    return;
+  }
+
+  const uint8_t* glyphs = con->glyphs + (y - row * con->fontHeight) * CONSOLE_CHARS;
+  const uint16_t* cell = con->cells + row * con->cols;
+  const uint16_t* end = cell + con->cols;
+
+  while (cell < end)
+  {
+    uint16_t c = *(cell++);
+    expandCell(dst, con->lut[c >> 8], glyphs[c & 0xff]);
+    dst += 4;
+  }
+
+  // the cursor is the cell with its attribute inverted
+  if (con->cursorVisible && row == con->cursorY && (con->frames & CONSOLE_BLINK_FRAMES))
+  {
+    uint16_t c = con->cells[row * con->cols + con->cursorX];
+    uint8_t attr = c >> 8;
+    attr = (attr << 4) | (attr >> 4);
+    expandCell((uint32_t*)pixels + con->cursorX * 4, con->lut[attr], glyphs[c & 0xff]);
+  }
+}
+
+/*
+ * call once per frame (eg. from vgaEndOfFrameFn) to blink the cursor
+ */
+void consoleEndOfFrame(VgaConsole* con)
+{
+  ++con->frames;
+}
@@ -0,0 +1,95 @@
+/*
+ * Project: pico-56 - vga text console
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+/*
+ * text mode console rendered straight into the vga line buffers. cells are
+ * 8 pixels wide and fontHeight lines high, eg. with an 8x8 font:
+ *
+ *   640x480 (h scale 1, v scale 2) -  80 x 30
+ *   800x600 (h scale 1, v scale 2) - 100 x 37
+ *
+ * each cell is a character and an attribute (bg << 4 | fg, palette indices)
+ */
+
+#define CONSOLE_COLOURS     16
+#define CONSOLE_CHARS       256
+#define CONSOLE_TAB_WIDTH   8
+#define CONSOLE_BLINK_FRAMES 32     // cursor blink half period
+
+#define CONSOLE_ATTR(fg, bg) ((uint8_t)(((bg) << 4) | ((fg) & 0x0f)))
+
+typedef struct
+{
+  uint16_t cols;
+  uint16_t rows;
+  uint8_t fontHeight;
+  uint16_t* cells;                  // (attr << 8) | char
+  uint8_t* glyphs;                  // font rows (in ram). glyphs[row * CONSOLE_CHARS + char]
+  uint32_t lut[256][4];             // two pixels for each attribute and pair of glyph bits
+  uint16_t palette[CONSOLE_COLOURS];
+  uint16_t cursorX;
+  uint16_t cursorY;
+  uint8_t attr;                     // attribute for printed characters
+  bool cursorVisible;
+  uint32_t frames;
+} VgaConsole;
+
+/*
+ * initialise a console. font is fontChars glyphs, 8 pixels wide (msb on the
+ * left) and fontHeight rows. returns false if out of memory
+ */
+bool consoleInit(VgaConsole* con, uint16_t cols, uint16_t rows, const uint8_t* font, uint16_t fontChars, uint8_t fontHeight);
+
+/*
+ * set one palette colour or the whole palette (CONSOLE_COLOURS entries)
+ */
+void consoleSetColour(VgaConsole* con, uint8_t index, uint16_t colour);
+void consoleSetPalette(VgaConsole* con, const uint16_t* palette);
+
+/*
+ * attribute for printed characters
+ */
+void consoleSetAttr(VgaConsole* con, uint8_t attr);
+
+/*
+ * clear the console (with the current attribute) and home the cursor
+ */
+void consoleClear(VgaConsole* con);
+
+void consoleSetCursor(VgaConsole* con, uint16_t x, uint16_t y);
+void consoleShowCursor(VgaConsole* con, bool show);
+
+/*
+ * set a cell directly
+ */
+void consoleSetCell(VgaConsole* con, uint16_t x, uint16_t y, uint8_t c, uint8_t attr);
+
+/*
+ * print at the cursor. handles \n, \r, \b and \t and scrolls at the bottom
+ */
+void consolePutChar(VgaConsole* con, char c);
+void consolePuts(VgaConsole* con, const char* str);
+void consolePrintf(VgaConsole* con, const char* fmt, ...);
+
+/*
+ * render line y (call from a vgaScanlineRgbFn)
+ */
+void consoleScanline(const VgaConsole* con, uint16_t y, uint16_t* pixels);
+
+/*
+ * call once per frame (eg. from vgaEndOfFrameFn) to blink the cursor
+ */
+void consoleEndOfFrame(VgaConsole* con);
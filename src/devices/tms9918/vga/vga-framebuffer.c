@@ -0,0 +1,782 @@
+/*
+ * Project: pico-56 - vga framebuffer
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "vga-framebuffer.h"
+
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+ /*
+  * spans are filled a word (eight pixels) at a time with partial bytes and
+  * nibbles at each end. lines are clipped once up front, then drawn without
+  * per-pixel bounds checks
+  *
+  * each primitive adds the (clipped) region it touched to the dirty list if
+  * the framebuffer has one. a double framebuffer uses it to copy only what
+  * changed into the other buffer after a flip
+  */
+
+#define NIBBLES(c) ((uint8_t)(((c) << 4) | ((c) & 0x0f)))
+
+// wasted pixels allowed when merging two dirty regions into one
+#define FB_DIRTY_MERGE_SLACK 64
+
+/*
+ * note a region (clipped, inclusive) has been drawn to
+ */
+static inline void markDirty(VgaFramebuffer* fb, int x0, int y0, int x1, int y1)
+{
+  if (fb->dirty) fbDirtyAdd(fb->dirty, x0, y0, x1, y1);
+}
+
+/*
+ * clip a region to the framebuffer and note it has been drawn to
+ */
+static inline void markDirtyClipped(VgaFramebuffer* fb, int x0, int y0, int x1, int y1)
+{
+  if (!fb->dirty) return;
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 >= fb->width) x1 = fb->width - 1;
+  if (y1 >= fb->height) y1 = fb->height - 1;
+  if (x0 <= x1 && y0 <= y1) fbDirtyAdd(fb->dirty, x0, y0, x1, y1);
+}
+
+/*
+ * address of the byte holding pixel x, y
+ */
+static inline uint8_t* pixelAddr(const VgaFramebuffer* fb, int x, int y)
+{
+  return fb->pixels + y * fb->stride + (x >> 1);
+}
+
+/*
+ * write one pixel (unclipped)
+ */
+static inline void plot(uint8_t* p, int x, uint8_t c)
+{
+  if (x & 1)
+  {
+    *p = (*p & 0xf0) | c;
+  }
+  else
+  {
+    *p = (*p & 0x0f) | (c << 4);
+  }
+}
+
+/*
+ * fill bytes [p, end) with dc, a word at a time where aligned
+ */
+static inline void fillBytes(uint8_t* p, uint8_t* end, uint8_t dc)
+{
+  while (p < end && ((uintptr_t)p & 3))
+  {
+    *(p++) = dc;
+  }
+
+  uint32_t* w = (uint32_t*)p;
+  uint32_t* wEnd = (uint32_t*)((uintptr_t)end & ~3);
+  uint32_t dw = dc * 0x01010101u;
+
+  while (w + 4 <= wEnd)
+  {
+    w[0] = dw;
+    w[1] = dw;
+    w[2] = dw;
+    w[3] = dw;
+    w += 4;
+  }
+  while (w < wEnd)
+  {
+    *(w++) = dw;
+  }
+
+  p = (uint8_t*)w;
+  while (p < end)
+  {
+    *(p++) = dc;
+  }
+}
+
+/*
+ * fill pixels x0 to x1 (inclusive, unclipped) of a row
+ */
+static inline void fillSpan(uint8_t* row, int x0, int x1, uint8_t c)
+{
+  uint8_t* p = row + (x0 >> 1);
+  uint8_t* end = row + (x1 >> 1) + 1;
+
+  if (x0 & 1)
+  {
+    *p = (*p & 0xf0) | c;
+    ++p;
+  }
+
+  if (!(x1 & 1))
+  {
+    --end;
+    *end = (*end & 0x0f) | (c << 4);
+  }
+
+  fillBytes(p, end, NIBBLES(c));
+}
+
+/*
+ * initialise a framebuffer over pixels (width / 2 * height bytes, word aligned)
+ */
+void fbInit(VgaFramebuffer* fb, uint8_t* pixels, uint16_t width, uint16_t height)
+{
+  fb->pixels = pixels;
+  fb->width = width;
+  fb->height = height;
+  fb->stride = width / 2;
+  fb->dirty = NULL;
+  memset(fb->palette, 0, sizeof(fb->palette));
+  memset(fb->dpal, 0, sizeof(fb->dpal));
+}
+
+/*
+ * set one palette colour
+ */
+void fbSetColour(VgaFramebuffer* fb, uint8_t index, uint16_t colour)
+{
+  index &= 0x0f;
+  fb->palette[index] = colour;
+
+  // every byte with this colour in either nibble
+  for (int i = 0; i < FB_COLOURS; ++i)
+  {
+    fb->dpal[(index << 4) | i] = colour | (fb->palette[i] << 16);
+    fb->dpal[(i << 4) | index] = fb->palette[i] | (colour << 16);
+  }
+}
+
+/*
+ * set the whole palette (FB_COLOURS entries)
+ */
+void fbSetPalette(VgaFramebuffer* fb, const uint16_t* palette)
+{
+  memcpy(fb->palette, palette, sizeof(fb->palette));
+  for (int i = 0; i < 256; ++i)
+  {
+    fb->dpal[i] = palette[i >> 4] | (palette[i & 0x0f] << 16);
+  }
+}
+
+/*
+ * fill the framebuffer
+ */
+void fbClear(VgaFramebuffer* fb, uint8_t c)
+{
+  markDirty(fb, 0, 0, fb->width - 1, fb->height - 1);
+  fillBytes(fb->pixels, fb->pixels + fb->stride * fb->height, NIBBLES(c));
+}
+
+/*
+ * write one pixel if it's within the framebuffer
+ */
+static inline void plotClipped(VgaFramebuffer* fb, int x, int y, uint8_t c)
+{
+  if ((unsigned)x >= fb->width || (unsigned)y >= fb->height) return;
+  plot(pixelAddr(fb, x, y), x, c);
+}
+
+/*
+ * clip a span of row y to the framebuffer. returns false if nothing is visible
+ */
+static inline bool clipSpan(const VgaFramebuffer* fb, int* x0, int* x1, int y)
+{
+  if ((unsigned)y >= fb->height) return false;
+  if (*x0 < 0) *x0 = 0;
+  if (*x1 >= fb->width) *x1 = fb->width - 1;
+  return *x0 <= *x1;
+}
+
+/*
+ * fill pixels y0 to y1 (inclusive, unclipped) of a column
+ */
+static void fillColumn(VgaFramebuffer* fb, int x, int y0, int y1, uint8_t c)
+{
+  uint8_t* p = pixelAddr(fb, x, y0);
+  uint8_t mask = (x & 1) ? 0xf0 : 0x0f;
+  uint8_t value = (x & 1) ? c : (c << 4);
+
+  for (int rows = y1 - y0 + 1; rows; --rows)
+  {
+    *p = (*p & mask) | value;
+    p += fb->stride;
+  }
+}
+
+/*
+ * set a pixel
+ */
+void fbSetPixel(VgaFramebuffer* fb, int x, int y, uint8_t c)
+{
+  if ((unsigned)x >= fb->width || (unsigned)y >= fb->height) return;
+  markDirty(fb, x, y, x, y);
+  plot(pixelAddr(fb, x, y), x, c & 0x0f);
+}
+
+/*
+ * get a pixel (0 outside the framebuffer)
+ */
+uint8_t fbGetPixel(const VgaFramebuffer* fb, int x, int y)
+{
+  if ((unsigned)x >= fb->width || (unsigned)y >= fb->height) return 0;
+  uint8_t b = *pixelAddr(fb, x, y);
+  return (x & 1) ? (b & 0x0f) : (b >> 4);
+}
+
+/*
+ * horizontal line of w pixels
+ */
+void fbHLine(VgaFramebuffer* fb, int x, int y, int w, uint8_t c)
+{
+  int x1 = x + w - 1;
+  if (!clipSpan(fb, &x, &x1, y)) return;
+
+  markDirty(fb, x, y, x1, y);
+  fillSpan(fb->pixels + y * fb->stride, x, x1, c & 0x0f);
+}
+
+/*
+ * vertical line of h pixels
+ */
+void fbVLine(VgaFramebuffer* fb, int x, int y, int h, uint8_t c)
+{
+  if ((unsigned)x >= fb->width) return;
+
+  int y1 = y + h - 1;
+  if (y < 0) y = 0;
+  if (y1 >= fb->height) y1 = fb->height - 1;
+  if (y > y1) return;
+
+  markDirty(fb, x, y, x, y1);
+  fillColumn(fb, x, y, y1, c & 0x0f);
+}
+
+#define CLIP_LEFT   0x01
+#define CLIP_RIGHT  0x02
+#define CLIP_TOP    0x04
+#define CLIP_BOTTOM 0x08
+
+/*
+ * cohen-sutherland outcode of a point
+ */
+static inline int outcode(const VgaFramebuffer* fb, int x, int y)
+{
+  int code = 0;
+  if (x < 0) code |= CLIP_LEFT;
+  else if (x >= fb->width) code |= CLIP_RIGHT;
+  if (y < 0) code |= CLIP_TOP;
+  else if (y >= fb->height) code |= CLIP_BOTTOM;
+  return code;
+}
+
+/*
+ * clip a line to the framebuffer. returns false if nothing is visible
+ */
+static bool clipLine(const VgaFramebuffer* fb, int* x0, int* y0, int* x1, int* y1)
+{
+  int code0 = outcode(fb, *x0, *y0);
+  int code1 = outcode(fb, *x1, *y1);
+
+  while (code0 | code1)
+  {
+    if (code0 & code1) return false;
+
+    int code = code0 ? code0 : code1;
+    int dx = *x1 - *x0, dy = *y1 - *y0;
+    int x, y;
+
+    if (code & CLIP_BOTTOM)
+    {
+      y = fb->height - 1;
+      x = *x0 + (int)((int64_t)dx * (y - *y0) / dy);
+    }
+    else if (code & CLIP_TOP)
+    {
+      y = 0;
+      x = *x0 + (int)((int64_t)dx * (y - *y0) / dy);
+    }
+    else if (code & CLIP_RIGHT)
+    {
+      x = fb->width - 1;
+      y = *y0 + (int)((int64_t)dy * (x - *x0) / dx);
+    }
+    else
+    {
+      x = 0;
+      y = *y0 + (int)((int64_t)dy * (x - *x0) / dx);
+    }
+
+    if (code == code0)
+    {
+      *x0 = x; *y0 = y;
+      code0 = outcode(fb, x, y);
+    }
+    else
+    {
+      *x1 = x; *y1 = y;
+      code1 = outcode(fb, x, y);
+    }
+  }
+  return true;
+}
+
+/*
+ * line from x0, y0 to x1, y1 (inclusive)
+ */
+void fbLine(VgaFramebuffer* fb, int x0, int y0, int x1, int y1, uint8_t c)
+{
+  if (!clipLine(fb, &x0, &y0, &x1, &y1)) return;
+
+  c &= 0x0f;
+
+  // always step down so the row pointer only moves forward
+  if (y0 > y1)
+  {
+    int t = x0; x0 = x1; x1 = t;
+    t = y0; y0 = y1; y1 = t;
+  }
+
+  if (x0 <= x1)
+  {
+    markDirty(fb, x0, y0, x1, y1);
+  }
+  else
+  {
+    markDirty(fb, x1, y0, x0, y1);
+  }
+
+  if (y0 == y1)
+  {
+    if (x0 > x1) { int t = x0; x0 = x1; x1 = t; }
+    fillSpan(fb->pixels + y0 * fb->stride, x0, x1, c);
+    return;
+  }
+
+  if (x0 == x1)
+  {
+    fillColumn(fb, x0, y0, y1, c);
+    return;
+  }
+
+  // bresenham
+
+  int dx = x1 - x0;
+  int sx = 1;
+  if (dx < 0)
+  {
+    dx = -dx;
+    sx = -1;
+  }
+  int dy = y1 - y0;
+  int err = dx - dy;
+
+  uint8_t* row = fb->pixels + y0 * fb->stride;
+  int x = x0;
+
+  for (;;)
+  {
+    plot(row + (x >> 1), x, c);
+    if (x == x1 && row == fb->pixels + y1 * fb->stride) break;
+
+    int e2 = err * 2;
+    if (e2 > -dy)
+    {
+      err -= dy;
+      x += sx;
+    }
+    if (e2 < dx)
+    {
+      err += dx;
+      row += fb->stride;
+    }
+  }
+}
+
+/*
+ * rectangle outline
+ */
+void fbRect(VgaFramebuffer* fb, int x, int y, int w, int h, uint8_t c)
+{
+  if (w <= 0 || h <= 0) return;
+
+  fbHLine(fb, x, y, w, c);
+  fbHLine(fb, x, y + h - 1, w, c);
+  fbVLine(fb, x, y + 1, h - 2, c);
+  fbVLine(fb, x + w - 1, y + 1, h - 2, c);
+}
+
+/*
+ * filled rectangle
+ */
+void fbFilledRect(VgaFramebuffer* fb, int x, int y, int w, int h, uint8_t c)
+{
+  int x1 = x + w - 1, y1 = y + h - 1;
+  if (x < 0) x = 0;
+  if (y < 0) y = 0;
+  if (x1 >= fb->width) x1 = fb->width - 1;
+  if (y1 >= fb->height) y1 = fb->height - 1;
+  if (x > x1 || y > y1) return;
+
+  markDirty(fb, x, y, x1, y1);
+  c &= 0x0f;
+
+  // full rows are one contiguous fill
+  if (x == 0 && x1 == fb->width - 1)
+  {
+    uint8_t* p = fb->pixels + y * fb->stride;
+    fillBytes(p, p + (y1 - y + 1) * fb->stride, NIBBLES(c));
+    return;
+  }
+
+  uint8_t* row = fb->pixels + y * fb->stride;
+  for (; y <= y1; ++y, row += fb->stride)
+  {
+    fillSpan(row, x, x1, c);
+  }
+}
+
+/*
+ * circle outline (midpoint)
+ */
+void fbCircle(VgaFramebuffer* fb, int cx, int cy, int r, uint8_t c)
+{
+  if (r < 0) return;
+
+  markDirtyClipped(fb, cx - r, cy - r, cx + r, cy + r);
+  c &= 0x0f;
+
+  int x = r, y = 0;
+  int err = 1 - r;
+
+  while (x >= y)
+  {
+    plotClipped(fb, cx + x, cy + y, c);
+    plotClipped(fb, cx - x, cy + y, c);
+    plotClipped(fb, cx + x, cy - y, c);
+    plotClipped(fb, cx - x, cy - y, c);
+    plotClipped(fb, cx + y, cy + x, c);
+    plotClipped(fb, cx - y, cy + x, c);
+    plotClipped(fb, cx + y, cy - x, c);
+    plotClipped(fb, cx - y, cy - x, c);
+
+    ++y;
+    if (err < 0)
+    {
+      err += 2 * y + 1;
+    }
+    else
+    {
+      --x;
+      err += 2 * (y - x) + 1;
+    }
+  }
+}
+
+/*
+ * filled circle. one span per row
+ */
+void fbFilledCircle(VgaFramebuffer* fb, int cx, int cy, int r, uint8_t c)
+{
+  if (r < 0) return;
+
+  markDirtyClipped(fb, cx - r, cy - r, cx + r, cy + r);
+  c &= 0x0f;
+
+  int limit = r * r + r;
+  int x = r;
+
+  for (int dy = 0; dy <= r; ++dy)
+  {
+    while (x * x + dy * dy > limit) --x;
+
+    int x0 = cx - x, x1 = cx + x;
+    if (clipSpan(fb, &x0, &x1, cy + dy))
+    {
+      fillSpan(fb->pixels + (cy + dy) * fb->stride, x0, x1, c);
+    }
+
+    x0 = cx - x; x1 = cx + x;
+    if (dy && clipSpan(fb, &x0, &x1, cy - dy))
+    {
+      fillSpan(fb->pixels + (cy - dy) * fb->stride, x0, x1, c);
+    }
+  }
+}
+
+/*
+ * copy a w x h 4bpp image (same packing, srcStride bytes per row) to x, y
+ */
+void fbBlit(VgaFramebuffer* fb, int x, int y, const uint8_t* src, uint16_t srcStride, int w, int h)
+{
+  int sx = 0, sy = 0;
+  if (x < 0) { sx = -x; w += x; x = 0; }
+  if (y < 0) { sy = -y; h += y; y = 0; }
+  if (x + w > fb->width) w = fb->width - x;
+  if (y + h > fb->height) h = fb->height - y;
+  if (w <= 0 || h <= 0) return;
+
+  markDirty(fb, x, y, x + w - 1, y + h - 1);
+
+  const uint8_t* srcRow = src + sy * srcStride;
+  uint8_t* dstRow = fb->pixels + y * fb->stride;
+
+  for (; h; --h, srcRow += srcStride, dstRow += fb->stride)
+  {
+    int dx = x, s = sx, n = w;
+
+    if ((dx ^ s) & 1)
+    {
+      // nibbles don't line up. pixel at a time
+      for (; n; --n, ++dx, ++s)
+      {
+        uint8_t b = srcRow[s >> 1];
+        plot(dstRow + (dx >> 1), dx, (s & 1) ? (b & 0x0f) : (b >> 4));
+      }
+      continue;
+    }
+
+    if (dx & 1)
+    {
+      plot(dstRow + (dx >> 1), dx, srcRow[s >> 1] & 0x0f);
+      ++dx; ++s; --n;
+    }
+
+    memcpy(dstRow + (dx >> 1), srcRow + (s >> 1), n >> 1);
+
+    if (n & 1)
+    {
+      dx += n - 1; s += n - 1;
+      plot(dstRow + (dx >> 1), dx, srcRow[s >> 1] >> 4);
+    }
+  }
+}
+
+/*
+ * expand row y to 12-bit pixels (call from a vgaScanlineRgbFn)
+ */
+void __time_critical_func(fbScanline)(const VgaFramebuffer* fb, uint16_t y, uint16_t* pixels)
+{
+  if (y >= fb->height) return;
+
+  const uint32_t* src = (const uint32_t*)(fb->pixels + y * fb->stride);
+  const uint32_t* end = src + (fb->stride >> 2);
+  const uint32_t* dpal = fb->dpal;
+  uint32_t* dst = (uint32_t*)pixels;
+
+  // one word of the framebuffer is eight pixels, four words of output
+  while (src < end)
+  {
+    uint32_t s = *(src++);
+    dst[0] = dpal[s & 0xff];
+    dst[1] = dpal[(s >> 8) & 0xff];
+    dst[2] = dpal[(s >> 16) & 0xff];
+    dst[3] = dpal[s >> 24];
+    dst += 4;
+  }
+}
+
+/*
+ * area of a region
+ */
+static inline int rectArea(int x0, int y0, int x1, int y1)
+{
+  return (x1 - x0 + 1) * (y1 - y0 + 1);
+}
+
+/*
+ * grow a region to include another
+ */
+static inline void rectUnion(FbRect* r, int x0, int y0, int x1, int y1)
+{
+  if (x0 < r->x0) r->x0 = x0;
+  if (y0 < r->y0) r->y0 = y0;
+  if (x1 > r->x1) r->x1 = x1;
+  if (y1 > r->y1) r->y1 = y1;
+}
+
+/*
+ * pixels wasted by merging a region into r
+ */
+static inline int mergeCost(const FbRect* r, int x0, int y0, int x1, int y1)
+{
+  FbRect u = *r;
+  rectUnion(&u, x0, y0, x1, y1);
+  return rectArea(u.x0, u.y0, u.x1, u.y1) - rectArea(r->x0, r->y0, r->x1, r->y1) - rectArea(x0, y0, x1, y1);
+}
+
+/*
+ * add a region to a dirty list (merging if it is full)
+ */
+void fbDirtyAdd(FbDirtyList* list, int x0, int y0, int x1, int y1)
+{
+  // merge with a region if it costs (almost) nothing
+  int best = -1;
+  int bestCost = INT32_MAX;
+  for (int i = 0; i < list->count; ++i)
+  {
+    int cost = mergeCost(&list->rects[i], x0, y0, x1, y1);
+    if (cost < bestCost)
+    {
+      best = i;
+      bestCost = cost;
+    }
+  }
+
+  if (best < 0 || (bestCost > FB_DIRTY_MERGE_SLACK && list->count < FB_DIRTY_RECTS))
+  {
+    FbRect* r = &list->rects[list->count++];
+    r->x0 = x0; r->y0 = y0;
+    r->x1 = x1; r->y1 = y1;
+    return;
+  }
+
+  // otherwise (or if the list is full) merge with the cheapest
+  rectUnion(&list->rects[best], x0, y0, x1, y1);
+}
+
+/*
+ * initialise a double framebuffer over two pixel buffers. both are cleared
+ */
+void fbDoubleInit(VgaDoubleFramebuffer* dfb, uint8_t* pixels0, uint8_t* pixels1, uint16_t width, uint16_t height)
+{
+  fbInit(&dfb->buffers[0], pixels0, width, height);
+  fbInit(&dfb->buffers[1], pixels1, width, height);
+  fbClear(&dfb->buffers[0], 0);
+  fbClear(&dfb->buffers[1], 0);
+  dfb->buffers[0].dirty = &dfb->dirty;
+  dfb->buffers[1].dirty = &dfb->dirty;
+  dfb->dirty.count = 0;
+  dfb->front = 0;
+  dfb->flipPending = false;
+
+  // a read and write address for each row plus a null block to finish
+  if (!dfb->copyBlocks) dfb->copyBlocks = malloc((height + 1) * 2 * sizeof(uint32_t));
+
+  dfb->copyDmaChan = dma_claim_unused_channel(true);
+  dfb->ctrlDmaChan = dma_claim_unused_channel(true);
+
+  // copy dma moves a row, then chains to the control dma for the next one
+  dma_channel_config copyConfig = dma_channel_get_default_config(dfb->copyDmaChan);
+  channel_config_set_transfer_data_size(&copyConfig, DMA_SIZE_32);
+  channel_config_set_read_increment(&copyConfig, true);
+  channel_config_set_write_increment(&copyConfig, true);
+  channel_config_set_chain_to(&copyConfig, dfb->ctrlDmaChan);
+  channel_config_set_irq_quiet(&copyConfig, true);                  // only flag a NULL control block
+  dma_channel_configure(dfb->copyDmaChan, &copyConfig, NULL, NULL, 0, false);
+
+  // control dma writes the read and write addresses to the copy channel (and triggers it)
+  dma_channel_config ctrlConfig = dma_channel_get_default_config(dfb->ctrlDmaChan);
+  channel_config_set_transfer_data_size(&ctrlConfig, DMA_SIZE_32);
+  channel_config_set_read_increment(&ctrlConfig, true);
+  channel_config_set_write_increment(&ctrlConfig, true);
+  channel_config_set_ring(&ctrlConfig, true, 3);                     // wrap every two words
+  dma_channel_configure(dfb->ctrlDmaChan, &ctrlConfig, &dma_hw->ch[dfb->copyDmaChan].al2_read_addr, dfb->copyBlocks, 2, false);
+}
+
+/*
+ * set one palette colour of both buffers
+ */
+void fbDoubleSetColour(VgaDoubleFramebuffer* dfb, uint8_t index, uint16_t colour)
+{
+  fbSetColour(&dfb->buffers[0], index, colour);
+  fbSetColour(&dfb->buffers[1], index, colour);
+}
+
+/*
+ * set the whole palette of both buffers
+ */
+void fbDoubleSetPalette(VgaDoubleFramebuffer* dfb, const uint16_t* palette)
+{
+  fbSetPalette(&dfb->buffers[0], palette);
+  fbSetPalette(&dfb->buffers[1], palette);
+}
+
+/*
+ * copy a region from one buffer to the other (dma, one row per control block)
+ */
+static void copyRect(VgaDoubleFramebuffer* dfb, const VgaFramebuffer* src, VgaFramebuffer* dst, const FbRect* r)
+{
+  // whole words. the buffers already match outside the dirty regions
+  uint32_t offset = r->y0 * src->stride + ((r->x0 >> 3) << 2);
+  uint32_t words = (r->x1 >> 3) - (r->x0 >> 3) + 1;
+  uint32_t rows = r->y1 - r->y0 + 1;
+
+  // full width regions are contiguous
+  if (words * 4 == src->stride)
+  {
+    words *= rows;
+    rows = 1;
+  }
+
+  uint32_t* block = dfb->copyBlocks;
+  for (uint32_t i = 0; i < rows; ++i, offset += src->stride)
+  {
+    *(block++) = (uint32_t)(src->pixels + offset);
+    *(block++) = (uint32_t)(dst->pixels + offset);
+  }
+  *(block++) = 0;
+  *(block++) = 0;
+
+  dma_hw->intr = 1u << dfb->copyDmaChan;
+  dma_channel_set_trans_count(dfb->copyDmaChan, words, false);
+  dma_channel_set_read_addr(dfb->ctrlDmaChan, dfb->copyBlocks, true);
+
+  while (!(dma_hw->intr & (1u << dfb->copyDmaChan)))
+  {
+    tight_loop_contents();
+  }
+  dma_hw->intr = 1u << dfb->copyDmaChan;
+}
+
+/*
+ * show the back buffer from the next frame. blocks until the flip has
+ * happened and the new back buffer has been brought up to date
+ */
+void fbFlip(VgaDoubleFramebuffer* dfb)
+{
+  __dmb();
+  dfb->flipPending = true;
+  while (dfb->flipPending)
+  {
+    tight_loop_contents();
+  }
+
+  // the old front buffer is missing what was drawn since the last flip
+  const VgaFramebuffer* front = &dfb->buffers[dfb->front];
+  VgaFramebuffer* back = fbBack(dfb);
+  for (int i = 0; i < dfb->dirty.count; ++i)
+  {
+    copyRect(dfb, front, back, &dfb->dirty.rects[i]);
+  }
+  dfb->dirty.count = 0;
+}
+
+/*
+ * call from the vga end of frame callback (vgaEndOfFrameFn)
+ */
+void __time_critical_func(fbDoubleEndOfFrame)(VgaDoubleFramebuffer* dfb)
+{
+  if (dfb->flipPending)
+  {
+    dfb->front ^= 1;
+    __dmb();
+    dfb->flipPending = false;
+  }
+}
@@ -0,0 +1,143 @@
+/*
+ * Project: pico-56 - vga framebuffer
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+/*
+ * 4bpp palettized framebuffer. two pixels per byte, left pixel in the high
+ * nibble. rows are word aligned (width is a multiple of 8)
+ */
+
+#define FB_COLOURS 16
+
+// regions tracked per frame before they start being merged
+#ifndef FB_DIRTY_RECTS
+#define FB_DIRTY_RECTS 32
+#endif
+
+typedef struct
+{
+  int16_t x0, y0, x1, y1;           // inclusive
+} FbRect;
+
+typedef struct
+{
+  FbRect rects[FB_DIRTY_RECTS];
+  uint16_t count;
+} FbDirtyList;
+
+typedef struct
+{
+  uint8_t* pixels;
+  uint16_t width;
+  uint16_t height;
+  uint16_t stride;                  // bytes per row
+  uint16_t palette[FB_COLOURS];     // 12-bit colours
+  uint32_t dpal[256];               // palette for a byte (two pixels)
+  FbDirtyList* dirty;               // optional. regions drawn to are added here
+} VgaFramebuffer;
+
+/*
+ * a pair of framebuffers. draw to the back buffer and flip - the flip takes
+ * effect at the end of a frame, then the regions drawn are copied (dma) to
+ * the new back buffer so both match again
+ */
+typedef struct
+{
+  VgaFramebuffer buffers[2];
+  FbDirtyList dirty;                // drawn to the back buffer since the last flip
+  volatile uint8_t front;
+  volatile bool flipPending;
+  int copyDmaChan;
+  int ctrlDmaChan;
+  uint32_t* copyBlocks;             // read, write address per row (dma control blocks)
+} VgaDoubleFramebuffer;
+
+/*
+ * initialise a framebuffer over pixels (width / 2 * height bytes, word aligned)
+ */
+void fbInit(VgaFramebuffer* fb, uint8_t* pixels, uint16_t width, uint16_t height);
+
+/*
+ * set one palette colour or the whole palette (FB_COLOURS entries)
+ */
+void fbSetColour(VgaFramebuffer* fb, uint8_t index, uint16_t colour);
+void fbSetPalette(VgaFramebuffer* fb, const uint16_t* palette);
+
+/*
+ * drawing. all coordinates are clipped to the framebuffer
+ */
+void fbClear(VgaFramebuffer* fb, uint8_t c);
+void fbSetPixel(VgaFramebuffer* fb, int x, int y, uint8_t c);
+uint8_t fbGetPixel(const VgaFramebuffer* fb, int x, int y);
+void fbHLine(VgaFramebuffer* fb, int x, int y, int w, uint8_t c);
+void fbVLine(VgaFramebuffer* fb, int x, int y, int h, uint8_t c);
+void fbLine(VgaFramebuffer* fb, int x0, int y0, int x1, int y1, uint8_t c);
+void fbRect(VgaFramebuffer* fb, int x, int y, int w, int h, uint8_t c);
+void fbFilledRect(VgaFramebuffer* fb, int x, int y, int w, int h, uint8_t c);
+void fbCircle(VgaFramebuffer* fb, int cx, int cy, int r, uint8_t c);
+void fbFilledCircle(VgaFramebuffer* fb, int cx, int cy, int r, uint8_t c);
+
+/*
+ * copy a w x h 4bpp image (same packing, srcStride bytes per row) to x, y
+ */
+void fbBlit(VgaFramebuffer* fb, int x, int y, const uint8_t* src, uint16_t srcStride, int w, int h);
+
+/*
+ * expand row y to 12-bit pixels (call from a vgaScanlineRgbFn)
+ */
+void fbScanline(const VgaFramebuffer* fb, uint16_t y, uint16_t* pixels);
+
+/*
+ * add a region to a dirty list (merging if it is full)
+ */
+void fbDirtyAdd(FbDirtyList* list, int x0, int y0, int x1, int y1);
+
+/*
+ * initialise a double framebuffer over two pixel buffers. both are cleared
+ */
+void fbDoubleInit(VgaDoubleFramebuffer* dfb, uint8_t* pixels0, uint8_t* pixels1, uint16_t width, uint16_t height);
+
+/*
+ * set one palette colour or the whole palette of both buffers
+ */
+void fbDoubleSetColour(VgaDoubleFramebuffer* dfb, uint8_t index, uint16_t colour);
+void fbDoubleSetPalette(VgaDoubleFramebuffer* dfb, const uint16_t* palette);
+
+/*
+ * the buffer to draw to
+ */
+static inline VgaFramebuffer* fbBack(VgaDoubleFramebuffer* dfb)
+{
+  return &dfb->buffers[dfb->front ^ 1];
+}
+
+/*
+ * show the back buffer from the next frame. blocks until the flip has
+ * happened and the new back buffer has been brought up to date
+ */
+void fbFlip(VgaDoubleFramebuffer* dfb);
+
+/*
+ * call from the vga end of frame callback (vgaEndOfFrameFn)
+ */
+void fbDoubleEndOfFrame(VgaDoubleFramebuffer* dfb);
+
+/*
+ * expand row y of the front buffer (call from a vgaScanlineRgbFn)
+ */
+static inline void fbDoubleScanline(const VgaDoubleFramebuffer* dfb, uint16_t y, uint16_t* pixels)
+{
+  fbScanline(&dfb->buffers[dfb->front], y, pixels);
+}
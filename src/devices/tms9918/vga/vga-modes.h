@@ -1,25 +1,61 @@
-/*
- * Project: pico-56 - vga
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-#pragma once
-
-#include "vga.h"
-
-typedef enum
-{
-  VGA_640_480_60HZ,
-  VGA_640_400_70HZ,
-  VGA_800_600_60HZ,
-  VGA_1024_768_60HZ,
-  VGA_1280_1024_60HZ,
-} VgaMode;
-
-extern VgaParams vgaGetParams(VgaMode mode, int pixelScale);
+/*
+ * Project: pico-56 - vga
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include "vga.h"
+
+typedef enum
+{
+  VGA_640_480_60HZ,
+  VGA_640_400_70HZ,
+  VGA_800_600_60HZ,
+  VGA_1024_768_60HZ,
+  VGA_1280_1024_60HZ,
+} VgaMode;
+
+/*
+ * mode timings: pixel clock (KHz), then display, front porch, sync and back
+ * porch pixels and sync polarity (1 = high). horizontal, then vertical
+ */
+#define VGA_640_480_60HZ_TIMING   (25175,  640, 16,  96,  48, 0,  480, 10, 2, 33, 0)  // http://tinyvga.com/vga-timing/640x480@60Hz
+#define VGA_640_400_70HZ_TIMING   (25175,  640, 16,  96,  48, 0,  400, 12, 2, 35, 1)  // http://tinyvga.com/vga-timing/640x400@70Hz
+#define VGA_800_600_60HZ_TIMING   (40000,  800, 40, 128,  88, 1,  600,  1, 4, 23, 1)  // http://tinyvga.com/vga-timing/800x600@60Hz
+#define VGA_1024_768_60HZ_TIMING  (65000, 1024, 24, 136, 160, 0,  768,  5, 6, 27, 0)  // http://tinyvga.com/vga-timing/1024x768@60Hz
+#define VGA_1280_1024_60HZ_TIMING (108000, 1280, 48, 112, 248, 1, 1024,  1, 3, 38, 1)  // http://tinyvga.com/vga-timing/1280x1024@60Hz
+
+#define VGA_TIMING_PIXEL_CLOCK(clk, hd, hfp, hs, hbp, hhi, vd, vfp, vs, vbp, vhi) (clk)
+#define VGA_TIMING_H_DISPLAY(clk, hd, hfp, hs, hbp, hhi, vd, vfp, vs, vbp, vhi)   (hd)
+#define VGA_TIMING_H_TOTAL(clk, hd, hfp, hs, hbp, hhi, vd, vfp, vs, vbp, vhi)     ((hd) + (hfp) + (hs) + (hbp))
+#define VGA_TIMING_V_DISPLAY(clk, hd, hfp, hs, hbp, hhi, vd, vfp, vs, vbp, vhi)   (vd)
+#define VGA_TIMING_V_TOTAL(clk, hd, hfp, hs, hbp, hhi, vd, vfp, vs, vbp, vhi)     ((vd) + (vfp) + (vs) + (vbp))
+
+/*
+ * a field of a mode's timing. eg. VGA_MODE_TIMING(VGA_800_600_60HZ, V_TOTAL)
+ */
+#define VGA_MODE_TIMING(mode, field) VGA_MODE_TIMING_(mode, field)
+#define VGA_MODE_TIMING_(mode, field) VGA_TIMING_APPLY(VGA_TIMING_ ## field, mode ## _TIMING)
+#define VGA_TIMING_APPLY(fn, timing) fn timing   // call fn with the timing fields
+
+/*
+ * fixed-mode builds (see pico56_add_vga_library() in CMakeLists.txt)
+ *
+ * with VGA_FIXED_MODE (a VgaMode) and VGA_FIXED_SCALE defined, the driver is
+ * built for that mode only. the frame geometry is compile-time constant and
+ * vgaInit() uses this mode whatever params.params says
+ */
+#ifdef VGA_FIXED_MODE
+#define VGA_FIXED_H_VIRTUAL_PIXELS (VGA_MODE_TIMING(VGA_FIXED_MODE, H_DISPLAY) / VGA_FIXED_SCALE)
+#define VGA_FIXED_V_VIRTUAL_PIXELS (VGA_MODE_TIMING(VGA_FIXED_MODE, V_DISPLAY) / VGA_FIXED_SCALE)
+#define VGA_FIXED_V_TOTAL_PIXELS   VGA_MODE_TIMING(VGA_FIXED_MODE, V_TOTAL)
+#endif
+
+extern VgaParams vgaGetParams(VgaMode mode, int pixelScale);
@@ -0,0 +1,168 @@
+/*
+ * Project: pico-56 - vga sprites
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "vga-sprite.h"
+
+#include "pico/stdlib.h"
+
+ /*
+  * blending is out = src * alpha + dst * (16 - alpha) >> 4 with src already
+  * premultiplied. the three channels of dst are spread into bytes so one
+  * multiply and shift does all of them. each channel of the sum is at most
+  * 15, so adding the premultiplied colour can't carry into the next
+  */
+
+/*
+ * blend a premultiplied 0xwbgr sprite pixel over a 12-bit pixel
+ */
+static inline uint16_t blend(uint16_t dst, uint16_t src)
+{
+  uint32_t weight = src >> 12;
+  uint32_t d = (dst & 0x00f) | ((dst & 0x0f0) << 4) | ((dst & 0xf00) << 8);
+  d = ((d * weight) >> 4) & 0x0f0f0f;
+  d = (d & 0x00f) | ((d >> 4) & 0x0f0) | ((d >> 8) & 0xf00);
+  return d + (src & 0x0fff);
+}
+
+/*
+ * composite a row entirely within the line
+ */
+static void __time_critical_func(drawRowUnclipped)(const uint16_t* span, uint16_t* dst)
+{
+  for (;;)
+  {
+    uint16_t header = *(span++);
+    uint16_t length = header & SPRITE_SPAN_LENGTH_MASK;
+
+    switch (header >> SPRITE_SPAN_TYPE_SHIFT)
+    {
+      case SPRITE_SPAN_SKIP:
+        if (!length) return;
+        break;
+
+      case SPRITE_SPAN_OPAQUE:
+        for (int i = 0; i < length; ++i)
+        {
+          dst[i] = span[i];
+        }
+        span += length;
+        break;
+
+      default:
+        for (int i = 0; i < length; ++i)
+        {
+          dst[i] = blend(dst[i], span[i]);
+        }
+        span += length;
+        break;
+    }
+    dst += length;
+  }
+}
+
+/*
+ * composite a row that hangs off either end of the line
+ */
+static void __time_critical_func(drawRowClipped)(const uint16_t* span, int x, uint16_t* pixels, uint16_t width)
+{
+  for (;;)
+  {
+    uint16_t header = *(span++);
+    int length = header & SPRITE_SPAN_LENGTH_MASK;
+    int type = header >> SPRITE_SPAN_TYPE_SHIFT;
+
+    if (!header || x >= width) return;
+
+    if (type != SPRITE_SPAN_SKIP)
+    {
+      // visible part of the span
+      int start = x < 0 ? -x : 0;
+      int end = (x + length > width) ? width - x : length;
+      uint16_t* dst = pixels + x;
+
+      if (type == SPRITE_SPAN_OPAQUE)
+      {
+        for (int i = start; i < end; ++i)
+        {
+          dst[i] = span[i];
+        }
+      }
+      else
+      {
+        for (int i = start; i < end; ++i)
+        {
+          dst[i] = blend(dst[i], span[i]);
+        }
+      }
+      span += length;
+    }
+    x += length;
+  }
+}
+
+/*
+ * composite a row of a sprite over a line of pixels at x (clipped to width)
+ */
+void __time_critical_func(spriteDrawRow)(const VgaSprite* sprite, int x, uint16_t row, uint16_t* pixels, uint16_t width)
+{
+  if (row >= sprite->height || x >= width || x + sprite->width <= 0) return;
+
+  const uint16_t* span = sprite->spans + sprite->rows[row];
+
+  if (x >= 0 && x + sprite->width <= width)
+  {
+    drawRowUnclipped(span, pixels + x);
+  }
+  else
+  {
+    drawRowClipped(span, x, pixels, width);
+  }
+}
+
+/*
+ * empty a sprite list
+ */
+void spriteListClear(VgaSpriteList* list)
+{
+  list->count = 0;
+}
+
+/*
+ * add a sprite to a list. returns false if the list is full
+ */
+bool spriteListAdd(VgaSpriteList* list, const VgaSprite* sprite, int x, int y)
+{
+  if (list->count >= VGA_SPRITE_LIST_SIZE) return false;
+
+  VgaSpritePos* pos = &list->sprites[list->count++];
+  pos->sprite = sprite;
+  pos->x = x;
+  pos->y = y;
+  return true;
+}
+
+/*
+ * composite every sprite in the list that covers line y
+ */
+void __time_critical_func(spriteListDrawLine)(const VgaSpriteList* list, uint16_t y, uint16_t* pixels, uint16_t width)
+{
+  const VgaSpritePos* pos = list->sprites;
+  const VgaSpritePos* end = pos + list->count;
+
+  for (; pos < end; ++pos)
+  {
+    uint32_t row = y - pos->y;
+    if (row < pos->sprite->height)
+    {
+      spriteDrawRow(pos->sprite, pos->x, row, pixels, width);
+    }
+  }
+}
@@ -0,0 +1,78 @@
+/*
+ * Project: pico-56 - vga sprites
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+/*
+ * span-encoded sprites with premultiplied alpha. generate them from images
+ * with tools/img2sprite.py (visrealm_generate_sprite_source() in cmake)
+ *
+ * each row is a list of spans ending with a zero header. a span header has
+ * the type in the top two bits and the length (pixels) in the rest:
+ *
+ *   skip    - transparent. no data
+ *   opaque  - length 12-bit 0xbgr colours
+ *   blend   - length 0xwbgr values: colour premultiplied by alpha and the
+ *             weight of the background (16 - alpha) in the top nibble
+ *
+ * trailing transparent pixels aren't encoded
+ */
+
+#define SPRITE_SPAN_SKIP        0
+#define SPRITE_SPAN_OPAQUE      1
+#define SPRITE_SPAN_BLEND       2
+#define SPRITE_SPAN_TYPE_SHIFT  14
+#define SPRITE_SPAN_LENGTH_MASK ((1 << SPRITE_SPAN_TYPE_SHIFT) - 1)
+
+// sprites in a sprite list
+#ifndef VGA_SPRITE_LIST_SIZE
+#define VGA_SPRITE_LIST_SIZE 32
+#endif
+
+typedef struct
+{
+  uint16_t width;
+  uint16_t height;
+  const uint32_t* rows;     // offset of each row in spans
+  const uint16_t* spans;
+} VgaSprite;
+
+typedef struct
+{
+  const VgaSprite* sprite;
+  int16_t x;
+  int16_t y;
+} VgaSpritePos;
+
+typedef struct
+{
+  VgaSpritePos sprites[VGA_SPRITE_LIST_SIZE];
+  uint16_t count;
+} VgaSpriteList;
+
+/*
+ * composite a row of a sprite over a line of pixels at x (clipped to width)
+ */
+void spriteDrawRow(const VgaSprite* sprite, int x, uint16_t row, uint16_t* pixels, uint16_t width);
+
+/*
+ * sprite lists. sprites are drawn in the order they were added
+ */
+void spriteListClear(VgaSpriteList* list);
+bool spriteListAdd(VgaSpriteList* list, const VgaSprite* sprite, int x, int y);
+
+/*
+ * composite every sprite in the list that covers line y
+ */
+void spriteListDrawLine(const VgaSpriteList* list, uint16_t y, uint16_t* pixels, uint16_t width);
@@ -1,366 +1,1030 @@
-/*
- * Project: pico-56 - vga
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-#include "vga.h"
-#include "vga.pio.h"
-#include "pio_utils.h"
-
-#include "pico/divider.h"
-#include "pico/multicore.h"
-
-#include "hardware/dma.h"
-#include "hardware/pio.h"
-#include "hardware/clocks.h"
-
-#include <math.h>
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-
-#define SYNC_PINS_START 0        // first sync pin gpio number
-#define SYNC_PINS_COUNT 2        // number of sync pins (h and v)
-
-#define RGB_PINS_START  2        // first rgb pin gpio number
-#define RGB_PINS_COUNT 12        // number of rgb pins
-
-#define VGA_PIO         pio0_hw  // which pio are we using for vga?
-#define SYNC_SM         0        // vga sync state machine index
-#define RGB_SM          1        // vga rgb state machine index
-
-
-#define END_OF_SCANLINE_MSG 0x40000000
-#define END_OF_FRAME_MSG 0x80000000
-
- /*
-  * sync pio dma data buffers
-  */
-uint32_t __aligned(4) syncDataActive[4];  // active display area
-uint32_t __aligned(4) syncDataPorch[4];   // vertical porch
-uint32_t __aligned(4) syncDataSync[4];    // vertical sync
-
-uint16_t* rgbDataBufferEven = NULL;
-uint16_t* rgbDataBufferOdd = NULL;
-
-/*
- * file scope
- */
-static int syncDmaChan = 0;
-static int rgbDmaChan = 0;
-static VgaInitParams vgaParams;
-
-uint32_t vgaMinimumPioClockKHz(VgaParams* params)
-{
-  if (params)
-  {
-    // we need a minimum of two clock cycles for each pixel
-    // if you're pixel doubling, you can go slower by a multiple
-    // of your doubling factor
-
-    return params->pixelClockKHz * vga_rgb_LOOP_TICKS / params->hPixelScale;
-  }
-}
-
-
-/*
- * build the sync data buffers
- */
-static bool buildSyncData()
-{
-  uint32_t sysClockKHz = clock_get_hz(clk_sys) / 1000;
-  uint32_t minClockKHz = vgaMinimumPioClockKHz(&vgaParams.params);
-  if (minClockKHz < 50000) minClockKHz *= 2;
-
-  if (sysClockKHz < minClockKHz)
-  {
-    printf("Error: System clock is %d KHz. Minimum required is %d KHz\n", sysClockKHz, minClockKHz);
-    return false;
-  }
-
-  if (!rgbDataBufferEven) rgbDataBufferEven = malloc(vgaParams.params.hVirtualPixels * sizeof(uint16_t));
-  if (!rgbDataBufferOdd) rgbDataBufferOdd = malloc(vgaParams.params.hVirtualPixels * sizeof(uint16_t));
-
-  vgaParams.params.pioDivider = round(sysClockKHz / (float)minClockKHz);
-  vgaParams.params.pioFreqKHz = sysClockKHz / vgaParams.params.pioDivider;
-
-  vgaParams.params.pioClocksPerPixel = vgaParams.params.pioFreqKHz / (float)vgaParams.params.pixelClockKHz;
-  vgaParams.params.pioClocksPerScaledPixel = vgaParams.params.pioFreqKHz * vgaParams.params.hPixelScale / (float)vgaParams.params.pixelClockKHz;
-
-  const uint32_t activeTicks = round(vgaParams.params.pioClocksPerPixel * (float)vgaParams.params.hSyncParams.displayPixels) - vga_sync_SETUP_OVERHEAD;
-  const uint32_t fPorchTicks = round(vgaParams.params.pioClocksPerPixel * (float)vgaParams.params.hSyncParams.frontPorchPixels) - vga_sync_SETUP_OVERHEAD;
-  const uint32_t syncTicks = round(vgaParams.params.pioClocksPerPixel * (float)vgaParams.params.hSyncParams.syncPixels) - vga_sync_SETUP_OVERHEAD;
-  const uint32_t bPorchTicks = round(vgaParams.params.pioClocksPerPixel * (float)vgaParams.params.hSyncParams.backPorchPixels) - vga_sync_SETUP_OVERHEAD;
-
-  uint32_t rgbCyclesPerPixel = round(vgaParams.params.pioClocksPerScaledPixel);
-
-
-  // compute sync bits
-  const uint32_t hSyncOff = (vgaParams.params.hSyncParams.syncHigh ? 0 : 1) << vga_sync_WORD_HSYNC_OFFSET;
-  const uint32_t hSyncOn = (vgaParams.params.hSyncParams.syncHigh ? 1 : 0) << vga_sync_WORD_HSYNC_OFFSET;
-  const uint32_t vSyncOff = (vgaParams.params.vSyncParams.syncHigh ? 0 : 1) << vga_sync_WORD_VSYNC_OFFSET;
-  const uint32_t vSyncOn = (vgaParams.params.vSyncParams.syncHigh ? 1 : 0) << vga_sync_WORD_VSYNC_OFFSET;
-
-  // compute exec instructions
-  const uint32_t instIrq = pio_encode_irq_set(false, vga_rgb_RGB_IRQ) << vga_sync_WORD_EXEC_OFFSET;
-  const uint32_t instNop = pio_encode_nop() << vga_sync_WORD_EXEC_OFFSET;
-
-  // sync data for an active display scanline
-  const int SYNC_LINE_ACTIVE = 0;
-  const int SYNC_LINE_FPORCH = 1;
-  const int SYNC_LINE_HSYNC = 2;
-  const int SYNC_LINE_BPORCH = 3;
-
-  syncDataActive[SYNC_LINE_ACTIVE] = instIrq | vSyncOff | hSyncOff | activeTicks;
-  syncDataActive[SYNC_LINE_FPORCH] = instNop | vSyncOff | hSyncOff | fPorchTicks;
-  syncDataActive[SYNC_LINE_HSYNC] = instNop | vSyncOff | hSyncOn | syncTicks;
-  syncDataActive[SYNC_LINE_BPORCH] = instNop | vSyncOff | hSyncOff | bPorchTicks;
-
-  // sync data for a front or back porch scanline
-  syncDataPorch[SYNC_LINE_ACTIVE] = instNop | vSyncOff | hSyncOff | activeTicks;
-  syncDataPorch[SYNC_LINE_FPORCH] = instNop | vSyncOff | hSyncOff | fPorchTicks;
-  syncDataPorch[SYNC_LINE_HSYNC] = instNop | vSyncOff | hSyncOn | syncTicks;
-  syncDataPorch[SYNC_LINE_BPORCH] = instNop | vSyncOff | hSyncOff | bPorchTicks;
-
-  // sync data for a vsync scanline
-  syncDataSync[SYNC_LINE_ACTIVE] = instNop | vSyncOn | hSyncOff | activeTicks;
-  syncDataSync[SYNC_LINE_FPORCH] = instNop | vSyncOn | hSyncOff | fPorchTicks;
-  syncDataSync[SYNC_LINE_HSYNC] = instNop | vSyncOn | hSyncOn | syncTicks;
-  syncDataSync[SYNC_LINE_BPORCH] = instNop | vSyncOn | hSyncOff | bPorchTicks;
-
-  return true;
-}
-
-
-/*
- * initialise the vga sync pio
- */
-static void vgaInitSync()
-{
-  buildSyncData();
-
-  // initalize sync pins for pio
-  for (uint i = 0; i < SYNC_PINS_COUNT; ++i)
-  {
-    pio_gpio_init(VGA_PIO, SYNC_PINS_START + i);
-  }
-
-  // add sync pio program
-  uint syncProgOffset = pio_add_program(VGA_PIO, &vga_sync_program);
-  pio_sm_set_consecutive_pindirs(VGA_PIO, SYNC_SM, SYNC_PINS_START, SYNC_PINS_COUNT, true);
-
-  // configure sync pio
-  pio_sm_config syncConfig = vga_sync_program_get_default_config(syncProgOffset);
-  sm_config_set_out_pins(&syncConfig, SYNC_PINS_START, 2);
-  sm_config_set_clkdiv(&syncConfig, vgaParams.params.pioDivider);
-  sm_config_set_out_shift(&syncConfig, true, true, 32); // R shift, autopull @ 32 bits
-  sm_config_set_fifo_join(&syncConfig, PIO_FIFO_JOIN_TX); // Join FIFOs together to get an 8 entry TX FIFO
-  pio_sm_init(VGA_PIO, SYNC_SM, syncProgOffset, &syncConfig);
-
-  // initialise sync dma
-  syncDmaChan = dma_claim_unused_channel(true);
-  dma_channel_config syncDmaChanConfig = dma_channel_get_default_config(syncDmaChan);
-  channel_config_set_transfer_data_size(&syncDmaChanConfig, DMA_SIZE_32);           // transfer 32 bits at a time
-  channel_config_set_read_increment(&syncDmaChanConfig, true);                       // increment read
-  channel_config_set_write_increment(&syncDmaChanConfig, false);                     // don't increment write 
-  channel_config_set_dreq(&syncDmaChanConfig, pio_get_dreq(VGA_PIO, SYNC_SM, true)); // transfer when there's space in fifo
-
-  // setup the dma channel and set it going
-  dma_channel_configure(syncDmaChan, &syncDmaChanConfig, &VGA_PIO->txf[SYNC_SM], syncDataSync, 4, false);
-  dma_channel_set_irq0_enabled(syncDmaChan, true);
-}
-
-
-/*
- * initialise the vga sync pio
- */
-static void vgaInitRgb()
-{
-  const uint32_t rgbCyclesPerPixel = round(vgaParams.params.pioClocksPerScaledPixel);
-
-  // copy the rgb program and set the appropriate pixel delay
-  uint16_t rgbProgramInstr[vga_rgb_program.length];
-  memcpy(rgbProgramInstr, vga_rgb_program.instructions, sizeof(rgbProgramInstr));
-  rgbProgramInstr[vga_rgb_DELAY_INSTR] |= pio_encode_delay(rgbCyclesPerPixel - vga_rgb_LOOP_TICKS);
-
-  pio_program_t rgbProgram = {
-    .instructions = rgbProgramInstr,
-    .length = vga_rgb_program.length,
-    .origin = vga_rgb_program.origin
-  };
-
-  // initalize sync pins for pio
-  for (uint i = 0; i < RGB_PINS_COUNT; ++i)
-  {
-    pio_gpio_init(VGA_PIO, RGB_PINS_START + i);
-  }
-
-  // add rgb pio program
-  pio_sm_set_consecutive_pindirs(VGA_PIO, RGB_SM, RGB_PINS_START, RGB_PINS_COUNT, true);
-  pio_set_y(VGA_PIO, RGB_SM, vgaParams.params.hVirtualPixels - 1);
-
-  uint rgbProgOffset = pio_add_program(VGA_PIO, &rgbProgram);
-  pio_sm_config rgbConfig = vga_rgb_program_get_default_config(rgbProgOffset);
-
-  sm_config_set_out_pins(&rgbConfig, RGB_PINS_START, RGB_PINS_COUNT);
-  sm_config_set_clkdiv(&rgbConfig, vgaParams.params.pioDivider);
-
-  sm_config_set_fifo_join(&rgbConfig, PIO_FIFO_JOIN_TX);
-
-  sm_config_set_out_shift(&rgbConfig, true, true, 16); // R shift, autopull @ 16 bits
-  pio_sm_init(VGA_PIO, RGB_SM, rgbProgOffset, &rgbConfig);
-
-  // initialise rgb dma
-  rgbDmaChan = dma_claim_unused_channel(true);
-  dma_channel_config rgbDmaChanConfig = dma_channel_get_default_config(rgbDmaChan);
-  channel_config_set_transfer_data_size(&rgbDmaChanConfig, DMA_SIZE_16);  // transfer 16 bits at a time
-  channel_config_set_read_increment(&rgbDmaChanConfig, true);             // increment read
-  channel_config_set_write_increment(&rgbDmaChanConfig, false);           // don;t increment write
-  channel_config_set_dreq(&rgbDmaChanConfig, pio_get_dreq(VGA_PIO, RGB_SM, true));
-
-  // setup the dma channel and set it going
-  dma_channel_configure(rgbDmaChan, &rgbDmaChanConfig, &VGA_PIO->txf[RGB_SM], rgbDataBufferEven, vgaParams.params.hVirtualPixels, false);
-  dma_channel_set_irq0_enabled(rgbDmaChan, true);
-}
-
-/*
- * dma interrupt handler
- */
-static void __time_critical_func(dmaIrqHandler)(void)
-{
-  static int currentTimingLine = -1;
-  static int currentDisplayLine = -1;
-
-  if (dma_hw->ints0 & (1u << syncDmaChan))
-  {
-    dma_hw->ints0 = 1u << syncDmaChan;
-
-    if (++currentTimingLine >= vgaParams.params.vSyncParams.totalPixels)
-    {
-      currentTimingLine = 0;
-      currentDisplayLine = 0;
-    }
-
-    if (currentTimingLine < vgaParams.params.vSyncParams.syncPixels)
-    {
-      dma_channel_set_read_addr(syncDmaChan, syncDataSync, true);
-    }
-    else if (currentTimingLine < (vgaParams.params.vSyncParams.syncPixels + vgaParams.params.vSyncParams.backPorchPixels))
-    {
-      dma_channel_set_read_addr(syncDmaChan, syncDataPorch, true);
-    }
-    else if (currentTimingLine < (vgaParams.params.vSyncParams.totalPixels - vgaParams.params.vSyncParams.frontPorchPixels))
-    {
-      dma_channel_set_read_addr(syncDmaChan, syncDataActive, true);
-    }
-    else
-    {
-      dma_channel_set_read_addr(syncDmaChan, syncDataPorch, true);
-    }
-    multicore_fifo_push_timeout_us(END_OF_SCANLINE_MSG | currentTimingLine, 0);
-  }
-
-
-  if (dma_hw->ints0 & (1u << rgbDmaChan))
-  {
-    dma_hw->ints0 = 1u << rgbDmaChan;
-
-    divmod_result_t pxLineVal = divmod_u32u32(currentDisplayLine++, vgaParams.params.vPixelScale);
-    uint32_t pxLine = to_quotient_u32(pxLineVal);
-    uint32_t pxLineRpt = to_remainder_u32(pxLineVal);
-
-    dma_channel_set_read_addr(rgbDmaChan, (pxLine & 1) ? rgbDataBufferOdd : rgbDataBufferEven, true);
-
-    // need a new line every X display lines
-    if ((pxLineRpt == 0))
-    {
-      uint32_t requestLine = pxLine + 1;
-      if (requestLine >= vgaParams.params.vVirtualPixels) requestLine -= vgaParams.params.vVirtualPixels;
-
-      multicore_fifo_push_timeout_us(requestLine, 0);
-
-      if (requestLine == vgaParams.params.vVirtualPixels - 1)
-      {
-        multicore_fifo_push_timeout_us(END_OF_FRAME_MSG, 0);
-      }
-    }
-  }
-}
-
-/*
- * initialise the pio dma
- */
-static void initDma()
-{
-  irq_set_exclusive_handler(DMA_IRQ_0, dmaIrqHandler);
-  irq_set_enabled(DMA_IRQ_0, true);
-
-  dma_channel_start(syncDmaChan);
-  dma_channel_start(rgbDmaChan);
-}
-
-/*
- * main vga loop
- */
-static void vgaLoop()
-{
-  uint64_t frameNumber = 0;
-  while (1)
-  {
-    uint32_t message = multicore_fifo_pop_blocking();
-
-    if (message == END_OF_FRAME_MSG)
-    {
-      if (vgaParams.endOfFrameFn)
-      {
-        vgaParams.endOfFrameFn(frameNumber);
-      }
-      ++frameNumber;
-    }
-    else if ((message & END_OF_SCANLINE_MSG) != 0)
-    {
-      if (vgaParams.endOfScanlineFn)
-      {
-        vgaParams.endOfScanlineFn();
-      }
-    }
-    else if (message & 0x01)
-    {
-      vgaParams.scanlineFn(message & 0xfff, &vgaParams.params, rgbDataBufferOdd);
-    }
-    else
-    {
-      vgaParams.scanlineFn(message & 0xfff, &vgaParams.params, rgbDataBufferEven);
-    }
-  }
-}
-
-
-/*
- * initialise the vga
- */
-void vgaInit(VgaInitParams params)
-{
-  vgaParams = params;
-
-  vgaInitSync();
-  vgaInitRgb();
-
-  initDma();
-
-  pio_sm_set_enabled(VGA_PIO, SYNC_SM, true);
-  pio_sm_set_enabled(VGA_PIO, RGB_SM, true);
-
-  multicore_launch_core1(vgaLoop);
-}
-
-VgaInitParams vgaCurrentParams()
-{
-  return vgaParams;
+/*
+ * Project: pico-56 - vga
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "vga.h"
+#include "vga-modes.h"
+#include "vga.pio.h"
+#include "pio_utils.h"
+
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/sync.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define SYNC_PINS_START 0        // first sync pin gpio number
+#define SYNC_PINS_COUNT 2        // number of sync pins (h and v)
+
+#define RGB_PINS_START  2        // first rgb pin gpio number
+#define RGB_PINS_COUNT 12        // number of rgb pins
+
+#define VGA_PIO         pio0_hw  // which pio are we using for vga?
+#define SYNC_SM         0        // vga sync state machine index
+#define RGB_SM          1        // vga rgb state machine index
+
+
+#define SCANLINE_IRQ    PIO0_IRQ_1  // end of scanline (handled on core1)
+
+#define END_OF_SCANLINE_MSG 0x40000000
+
+#define VGA_PERI_CLOCK_HZ (48 * MHZ)  // clk_peri (usb pll) once the clock multiple changes
+
+#define MSG_RING_SIZE   16       // irq -> core1 messages (power of two)
+#define MSG_RING_MASK   (MSG_RING_SIZE - 1)
+
+#if (VGA_LINE_RING_SIZE < 2) || (VGA_LINE_RING_SIZE & (VGA_LINE_RING_SIZE - 1))
+#error "VGA_LINE_RING_SIZE must be a power of two (at least 2)"
+#endif
+
+#define RING_MASK (VGA_LINE_RING_SIZE - 1)
+#define RING_EMPTY_SEQ 0xffffffff
+
+/*
+ * frame geometry. constants in a fixed-mode build (see vga-modes.h)
+ */
+#ifdef VGA_FIXED_MODE
+#define H_VIRTUAL_PIXELS  VGA_FIXED_H_VIRTUAL_PIXELS
+#define V_VIRTUAL_PIXELS  VGA_FIXED_V_VIRTUAL_PIXELS
+#define V_PIXEL_SCALE     VGA_FIXED_SCALE
+#else
+#define H_VIRTUAL_PIXELS  vgaParams.params.hVirtualPixels
+#define V_VIRTUAL_PIXELS  vgaParams.params.vVirtualPixels
+#define V_PIXEL_SCALE     vgaParams.params.vPixelScale
+#endif
+
+ /*
+  * sync pio dma data buffers
+  */
+uint32_t __aligned(4) syncDataActive[4];  // active display area
+uint32_t __aligned(4) syncDataPorch[4];   // vertical porch
+uint32_t __aligned(4) syncDataSync[4];    // vertical sync
+
+/*
+ * sync control blocks - one read address per scanline for a whole frame,
+ * NULL terminated. the control channel feeds these to the sync channel
+ * which chains back to it after each line. the NULL raises the only sync
+ * interrupt of the frame
+ */
+static const uint32_t** syncFrameBlocks = NULL;
+
+/*
+ * rgb control blocks - the current virtual line's buffer, once for each
+ * repeat (vPixelScale), NULL terminated. the rgb channel only interrupts
+ * (on the NULL) when it needs the next virtual line
+ */
+static const uint16_t** rgbLineBlocks = NULL;
+
+/*
+ * scanline ring
+ *
+ * core1 renders virtual lines into the ring ahead of the beam. each line has
+ * a sequence number (counting from the first line of the first frame) and is
+ * stored in slot (seq & RING_MASK), tagged with that number. the dma irq
+ * takes slot (displaySeq & RING_MASK) when the tag matches, otherwise it
+ * repeats the previous line and counts an underrun
+ *
+ * the first VGA_PRERENDER_LINES lines of each frame have slots of their own
+ * after the ring (VGA_LINE_RING_SIZE + y). they only have to wait for the
+ * same line of the previous frame to be shown, so the top of the next frame
+ * can be rendered during vertical blanking rather than all at once when the
+ * display starts
+ */
+static uint16_t* rgbLineBuffers[VGA_LINE_BUFFERS];
+static const uint16_t* volatile rgbLineSource[VGA_LINE_BUFFERS];  // a line buffer or a prebuilt line
+static volatile uint32_t rgbLineSeq[VGA_LINE_BUFFERS];
+
+static volatile uint32_t displaySeq = 0;   // next line the irq will display
+static uint32_t displayFrameSeq = 0;       // first line of the current frame
+
+/*
+ * message ring
+ *
+ * single producer (scanline irq) / single consumer (vgaLoop). the irq rings
+ * the doorbell (sev) after each message so the loop can wait with wfe
+ */
+static volatile uint32_t msgRing[MSG_RING_SIZE];
+static volatile uint32_t msgHead = 0;      // written by the scanline irq
+static volatile uint32_t msgTail = 0;      // written by core1
+
+/*
+ * cooperative rendering
+ *
+ * core0 can render lines ahead of core1 (vgaHelpRender) when it would
+ * otherwise be waiting. both cores claim lines in order from claimSeq under
+ * renderLock. the helper never takes the last line of a frame, so core1
+ * always finishes each frame, and it only takes lines of a frame once the
+ * end of frame callback has prepared it
+ */
+static spin_lock_t* renderLock = NULL;
+static volatile uint32_t claimSeq = 0;     // next line to render (either core)
+static volatile uint32_t readyFrameSeq = 0;  // first line of the prepared frame
+static volatile bool helperBusy = false;   // core0 is rendering a line
+
+static volatile VgaStats stats;
+
+#if VGA_DEADLINE_MONITOR
+
+static uint32_t frameLateLines = 0;   // this frame (core1)
+static uint32_t frameLineMax = 0;
+
+/*
+ * start a timing (core1 systick, counting down)
+ */
+static inline uint32_t timingStart()
+{
+  return systick_hw->cvr;
+}
+
+/*
+ * finish a timing. returns cycles elapsed and adds them to a histogram
+ */
+static inline uint32_t timingEnd(uint32_t start, uint32_t budget, volatile uint32_t* histogram, volatile uint32_t* max)
+{
+  uint32_t cycles = (start - systick_hw->cvr) & 0x00ffffff;
+  stats.busyCycles += cycles;
+
+  uint32_t bucket = budget ? (cycles * 4 / budget) : 0;
+  if (bucket >= VGA_TIMING_BUCKETS) bucket = VGA_TIMING_BUCKETS - 1;
+  ++histogram[bucket];
+
+  if (cycles > *max) *max = cycles;
+  return cycles;
+}
+
+#endif
+
+/*
+ * file scope
+ */
+static int syncDmaChan = 0;
+static int syncCtrlDmaChan = 0;
+static int rgbDmaChan = 0;
+static int rgbCtrlDmaChan = 0;
+static uint rgbProgOffset = 0;
+static VgaInitParams vgaParams;
+
+static volatile bool parkRequested = false;
+static volatile bool parked = false;
+
+/*
+ * buffer slot for line seq (virtual line y)
+ */
+static inline uint32_t lineSlot(uint32_t seq, uint16_t y)
+{
+  return (y < VGA_PRERENDER_LINES) ? (VGA_LINE_RING_SIZE + y) : (seq & RING_MASK);
+}
+
+/*
+ * can line seq be rendered now? (its slot isn't waiting to be, or being, shown)
+ */
+static inline bool lineWritable(uint32_t seq, uint16_t y, uint32_t shownSeq)
+{
+  if (y < VGA_PRERENDER_LINES)
+  {
+    // the previous frame's line y must be done
+    return (int32_t)(shownSeq - (seq - V_VIRTUAL_PIXELS)) >= 2;
+  }
+  return (seq - shownSeq) < (VGA_LINE_RING_SIZE - 1);
+}
+
+uint32_t vgaMinimumPioClockKHz(VgaParams* params)
+{
+  if (params)
+  {
+    // we need a minimum of two clock cycles for each pixel
+    // if you're pixel doubling, you can go slower by a multiple
+    // of your doubling factor
+
+    return params->pixelClockKHz * vga_rgb_LOOP_TICKS / params->hPixelScale;
+  }
+}
+
+
+/*
+ * set the system clock as close as we can get to clockKHz (10KHz steps).
+ * returns the actual clock
+ */
+uint32_t vgaSetSysClockKHz(uint32_t clockKHz)
+{
+  clockKHz /= 10;
+  clockKHz *= 10;
+
+  uint32_t offset = 0;
+  while (!set_sys_clock_khz(clockKHz + offset, false)) {
+    offset += 10;
+    if (set_sys_clock_khz(clockKHz - offset, false)) break;
+  }
+
+  return clock_get_hz(clk_sys) / 1000;
+}
+
+/*
+ * time available for each line (in cpu cycles)
+ */
+static void updateBudgets(uint32_t sysClockKHz)
+{
+  stats.tickBudget = (uint64_t)vgaParams.params.hSyncParams.totalPixels * sysClockKHz / vgaParams.params.pixelClockKHz;
+  stats.lineBudget = stats.tickBudget * V_PIXEL_SCALE;
+}
+
+/*
+ * build the sync data buffers
+ */
+static bool buildSyncData()
+{
+  uint32_t sysClockKHz = clock_get_hz(clk_sys) / 1000;
+  uint32_t minClockKHz = vgaMinimumPioClockKHz(&vgaParams.params);
+  if (minClockKHz < 50000) minClockKHz *= 2;
+
+  if (sysClockKHz < minClockKHz)
+  {
+    printf("Error: System clock is %d KHz. Minimum required is %d KHz\n", sysClockKHz, minClockKHz);
+    return false;
+  }
+
+#ifdef VGA_FIXED_MODE
+  static const uint16_t* fixedLineBlocks[V_PIXEL_SCALE + 1];
+  static uint16_t __aligned(4) fixedLineBuffers[VGA_LINE_BUFFERS][H_VIRTUAL_PIXELS];
+  rgbLineBlocks = fixedLineBlocks;
+#else
+  if (!rgbLineBlocks) rgbLineBlocks = malloc((V_PIXEL_SCALE + 1) * sizeof(uint16_t*));
+#endif
+  rgbLineBlocks[V_PIXEL_SCALE] = NULL;
+
+  for (int i = 0; i < VGA_LINE_BUFFERS; ++i)
+  {
+#ifdef VGA_FIXED_MODE
+    rgbLineBuffers[i] = fixedLineBuffers[i];
+#else
+    if (!rgbLineBuffers[i]) rgbLineBuffers[i] = malloc(H_VIRTUAL_PIXELS * sizeof(uint16_t));
+#endif
+    rgbLineSource[i] = rgbLineBuffers[i];
+    rgbLineSeq[i] = RING_EMPTY_SEQ;
+  }
+
+  vgaParams.params.pioDivider = round(sysClockKHz / (float)minClockKHz);
+  vgaParams.params.pioFreqKHz = sysClockKHz / vgaParams.params.pioDivider;
+
+  vgaParams.params.pioClocksPerPixel = vgaParams.params.pioFreqKHz / (float)vgaParams.params.pixelClockKHz;
+  vgaParams.params.pioClocksPerScaledPixel = vgaParams.params.pioFreqKHz * vgaParams.params.hPixelScale / (float)vgaParams.params.pixelClockKHz;
+
+  const uint32_t activeTicks = round(vgaParams.params.pioClocksPerPixel * (float)vgaParams.params.hSyncParams.displayPixels) - vga_sync_SETUP_OVERHEAD;
+  const uint32_t fPorchTicks = round(vgaParams.params.pioClocksPerPixel * (float)vgaParams.params.hSyncParams.frontPorchPixels) - vga_sync_SETUP_OVERHEAD;
+  const uint32_t syncTicks = round(vgaParams.params.pioClocksPerPixel * (float)vgaParams.params.hSyncParams.syncPixels) - vga_sync_SETUP_OVERHEAD;
+  const uint32_t bPorchTicks = round(vgaParams.params.pioClocksPerPixel * (float)vgaParams.params.hSyncParams.backPorchPixels) - vga_sync_SETUP_OVERHEAD;
+
+  uint32_t rgbCyclesPerPixel = round(vgaParams.params.pioClocksPerScaledPixel);
+
+  updateBudgets(sysClockKHz);
+
+
+  // compute sync bits
+  const uint32_t hSyncOff = (vgaParams.params.hSyncParams.syncHigh ? 0 : 1) << vga_sync_WORD_HSYNC_OFFSET;
+  const uint32_t hSyncOn = (vgaParams.params.hSyncParams.syncHigh ? 1 : 0) << vga_sync_WORD_HSYNC_OFFSET;
+  const uint32_t vSyncOff = (vgaParams.params.vSyncParams.syncHigh ? 0 : 1) << vga_sync_WORD_VSYNC_OFFSET;
+  const uint32_t vSyncOn = (vgaParams.params.vSyncParams.syncHigh ? 1 : 0) << vga_sync_WORD_VSYNC_OFFSET;
+
+  // compute exec instructions. the exec field holds a whole instruction, so
+  // each word gets exactly one of these (never or'd together)
+  const uint32_t instIrq = pio_encode_irq_set(false, vga_rgb_RGB_IRQ) << vga_sync_WORD_EXEC_OFFSET;
+  const uint32_t instNop = pio_encode_nop() << vga_sync_WORD_EXEC_OFFSET;
+  const uint32_t instLineIrq = pio_encode_irq_set(false, vga_sync_SCANLINE_IRQ) << vga_sync_WORD_EXEC_OFFSET;
+
+  const int SYNC_LINE_ACTIVE = 0;
+  const int SYNC_LINE_FPORCH = 1;
+  const int SYNC_LINE_HSYNC = 2;
+  const int SYNC_LINE_BPORCH = 3;
+
+  // sync data for an active display scanline. on every line, the front
+  // porch tells core1 that the line has ended
+  syncDataActive[SYNC_LINE_ACTIVE] = instIrq | vSyncOff | hSyncOff | activeTicks;
+  syncDataActive[SYNC_LINE_FPORCH] = instLineIrq | vSyncOff | hSyncOff | fPorchTicks;
+  syncDataActive[SYNC_LINE_HSYNC] = instNop | vSyncOff | hSyncOn | syncTicks;
+  syncDataActive[SYNC_LINE_BPORCH] = instNop | vSyncOff | hSyncOff | bPorchTicks;
+
+  // sync data for a front or back porch scanline
+  syncDataPorch[SYNC_LINE_ACTIVE] = instNop | vSyncOff | hSyncOff | activeTicks;
+  syncDataPorch[SYNC_LINE_FPORCH] = instLineIrq | vSyncOff | hSyncOff | fPorchTicks;
+  syncDataPorch[SYNC_LINE_HSYNC] = instNop | vSyncOff | hSyncOn | syncTicks;
+  syncDataPorch[SYNC_LINE_BPORCH] = instNop | vSyncOff | hSyncOff | bPorchTicks;
+
+  // sync data for a vsync scanline
+  syncDataSync[SYNC_LINE_ACTIVE] = instNop | vSyncOn | hSyncOff | activeTicks;
+  syncDataSync[SYNC_LINE_FPORCH] = instLineIrq | vSyncOn | hSyncOff | fPorchTicks;
+  syncDataSync[SYNC_LINE_HSYNC] = instNop | vSyncOn | hSyncOn | syncTicks;
+  syncDataSync[SYNC_LINE_BPORCH] = instNop | vSyncOn | hSyncOff | bPorchTicks;
+
+  // the whole frame
+  const VgaSyncParams* vSync = &vgaParams.params.vSyncParams;
+#ifdef VGA_FIXED_MODE
+  static const uint32_t* fixedFrameBlocks[VGA_FIXED_V_TOTAL_PIXELS + 1];
+  syncFrameBlocks = fixedFrameBlocks;
+#else
+  if (!syncFrameBlocks) syncFrameBlocks = malloc((vSync->totalPixels + 1) * sizeof(uint32_t*));
+#endif
+
+  for (uint32_t line = 0; line < vSync->totalPixels; ++line)
+  {
+    if (line < vSync->syncPixels)
+    {
+      syncFrameBlocks[line] = syncDataSync;
+    }
+    else if (line < (vSync->syncPixels + vSync->backPorchPixels))
+    {
+      syncFrameBlocks[line] = syncDataPorch;
+    }
+    else if (line < (vSync->totalPixels - vSync->frontPorchPixels))
+    {
+      syncFrameBlocks[line] = syncDataActive;
+    }
+    else
+    {
+      syncFrameBlocks[line] = syncDataPorch;
+    }
+  }
+  syncFrameBlocks[vSync->totalPixels] = NULL;
+
+  return true;
+}
+
+
+/*
+ * initialise the vga sync pio
+ */
+static void vgaInitSync()
+{
+  buildSyncData();
+
+  // initalize sync pins for pio
+  for (uint i = 0; i < SYNC_PINS_COUNT; ++i)
+  {
+    pio_gpio_init(VGA_PIO, SYNC_PINS_START + i);
+  }
+
+  // add sync pio program
+  uint syncProgOffset = pio_add_program(VGA_PIO, &vga_sync_program);
+  pio_sm_set_consecutive_pindirs(VGA_PIO, SYNC_SM, SYNC_PINS_START, SYNC_PINS_COUNT, true);
+
+  // configure sync pio
+  pio_sm_config syncConfig = vga_sync_program_get_default_config(syncProgOffset);
+  sm_config_set_out_pins(&syncConfig, SYNC_PINS_START, 2);
+  sm_config_set_clkdiv(&syncConfig, vgaParams.params.pioDivider);
+  sm_config_set_out_shift(&syncConfig, true, true, 32); // R shift, autopull @ 32 bits
+  sm_config_set_fifo_join(&syncConfig, PIO_FIFO_JOIN_TX); // Join FIFOs together to get an 8 entry TX FIFO
+  pio_sm_init(VGA_PIO, SYNC_SM, syncProgOffset, &syncConfig);
+
+  // end of scanline irq (routed to core1 in vgaLoop)
+  pio_set_irq1_source_enabled(VGA_PIO, pis_interrupt0 + vga_sync_SCANLINE_IRQ, true);
+
+  // initialise sync dma
+  syncDmaChan = dma_claim_unused_channel(true);
+  syncCtrlDmaChan = dma_claim_unused_channel(true);
+
+  dma_channel_config syncDmaChanConfig = dma_channel_get_default_config(syncDmaChan);
+  channel_config_set_transfer_data_size(&syncDmaChanConfig, DMA_SIZE_32);           // transfer 32 bits at a time
+  channel_config_set_read_increment(&syncDmaChanConfig, true);                       // increment read
+  channel_config_set_write_increment(&syncDmaChanConfig, false);                     // don't increment write 
+  channel_config_set_dreq(&syncDmaChanConfig, pio_get_dreq(VGA_PIO, SYNC_SM, true)); // transfer when there's space in fifo
+  channel_config_set_chain_to(&syncDmaChanConfig, syncCtrlDmaChan);                  // fetch the next line's control block
+  channel_config_set_irq_quiet(&syncDmaChanConfig, true);                            // only interrupt on a NULL control block
+
+  dma_channel_configure(syncDmaChan, &syncDmaChanConfig, &VGA_PIO->txf[SYNC_SM], syncDataSync, 4, false);
+  dma_channel_set_irq0_enabled(syncDmaChan, true);
+
+  // control dma writes each line's sync data address to the sync channel (and triggers it)
+  dma_channel_config syncCtrlDmaChanConfig = dma_channel_get_default_config(syncCtrlDmaChan);
+  channel_config_set_transfer_data_size(&syncCtrlDmaChanConfig, DMA_SIZE_32);
+  channel_config_set_read_increment(&syncCtrlDmaChanConfig, true);
+  channel_config_set_write_increment(&syncCtrlDmaChanConfig, false);
+
+  dma_channel_configure(syncCtrlDmaChan, &syncCtrlDmaChanConfig, &dma_hw->ch[syncDmaChan].al3_read_addr_trig, syncFrameBlocks, 1, false);
+}
+
+
+/*
+ * initialise the vga sync pio
+ */
+static void vgaInitRgb()
+{
+  const uint32_t rgbCyclesPerPixel = round(vgaParams.params.pioClocksPerScaledPixel);
+
+  // copy the rgb program and set the appropriate pixel delay
+  uint16_t rgbProgramInstr[vga_rgb_program.length];
+  memcpy(rgbProgramInstr, vga_rgb_program.instructions, sizeof(rgbProgramInstr));
+  rgbProgramInstr[vga_rgb_DELAY_INSTR] |= pio_encode_delay(rgbCyclesPerPixel - vga_rgb_LOOP_TICKS);
+
+  pio_program_t rgbProgram = {
+    .instructions = rgbProgramInstr,
+    .length = vga_rgb_program.length,
+    .origin = vga_rgb_program.origin
+  };
+
+  // initalize sync pins for pio
+  for (uint i = 0; i < RGB_PINS_COUNT; ++i)
+  {
+    pio_gpio_init(VGA_PIO, RGB_PINS_START + i);
+  }
+
+  // add rgb pio program
+  pio_sm_set_consecutive_pindirs(VGA_PIO, RGB_SM, RGB_PINS_START, RGB_PINS_COUNT, true);
+  pio_set_y(VGA_PIO, RGB_SM, H_VIRTUAL_PIXELS - 1);
+
+  rgbProgOffset = pio_add_program(VGA_PIO, &rgbProgram);
+  pio_sm_config rgbConfig = vga_rgb_program_get_default_config(rgbProgOffset);
+
+  sm_config_set_out_pins(&rgbConfig, RGB_PINS_START, RGB_PINS_COUNT);
+  sm_config_set_clkdiv(&rgbConfig, vgaParams.params.pioDivider);
+
+  sm_config_set_fifo_join(&rgbConfig, PIO_FIFO_JOIN_TX);
+
+  sm_config_set_out_shift(&rgbConfig, true, true, 16); // R shift, autopull @ 16 bits
+  pio_sm_init(VGA_PIO, RGB_SM, rgbProgOffset, &rgbConfig);
+
+  // initialise rgb dma
+  rgbDmaChan = dma_claim_unused_channel(true);
+  rgbCtrlDmaChan = dma_claim_unused_channel(true);
+
+  dma_channel_config rgbDmaChanConfig = dma_channel_get_default_config(rgbDmaChan);
+  channel_config_set_transfer_data_size(&rgbDmaChanConfig, DMA_SIZE_16);  // transfer 16 bits at a time
+  channel_config_set_read_increment(&rgbDmaChanConfig, true);             // increment read
+  channel_config_set_write_increment(&rgbDmaChanConfig, false);           // don;t increment write
+  channel_config_set_dreq(&rgbDmaChanConfig, pio_get_dreq(VGA_PIO, RGB_SM, true));
+  channel_config_set_chain_to(&rgbDmaChanConfig, rgbCtrlDmaChan);         // repeat the line (or stop)
+  channel_config_set_irq_quiet(&rgbDmaChanConfig, true);                  // only interrupt on a NULL control block
+
+  dma_channel_configure(rgbDmaChan, &rgbDmaChanConfig, &VGA_PIO->txf[RGB_SM], rgbLineBuffers[0], H_VIRTUAL_PIXELS, false);
+  dma_channel_set_irq0_enabled(rgbDmaChan, true);
+
+  // control dma writes the line buffer address to the rgb channel (and triggers it)
+  dma_channel_config rgbCtrlDmaChanConfig = dma_channel_get_default_config(rgbCtrlDmaChan);
+  channel_config_set_transfer_data_size(&rgbCtrlDmaChanConfig, DMA_SIZE_32);
+  channel_config_set_read_increment(&rgbCtrlDmaChanConfig, true);
+  channel_config_set_write_increment(&rgbCtrlDmaChanConfig, false);
+
+  dma_channel_configure(rgbCtrlDmaChan, &rgbCtrlDmaChanConfig, &dma_hw->ch[rgbDmaChan].al3_read_addr_trig, rgbLineBlocks, 1, false);
+}
+
+/*
+ * post a message to core1's loop (dropped if it is that far behind)
+ */
+static inline void postMessage(uint32_t message)
+{
+  uint32_t head = msgHead;
+  if (head - msgTail >= MSG_RING_SIZE)
+  {
+    ++stats.messageOverruns;
+    return;
+  }
+
+  msgRing[head & MSG_RING_MASK] = message;
+  __dmb();
+  msgHead = head + 1;
+  __sev();
+}
+
+/*
+ * end of scanline interrupt handler (core1)
+ */
+static void __time_critical_func(scanlineIrqHandler)(void)
+{
+  pio_interrupt_clear(VGA_PIO, vga_sync_SCANLINE_IRQ);
+  postMessage(END_OF_SCANLINE_MSG);
+}
+
+/*
+ * queue the next virtual line on the rgb dma (displayed vPixelScale times)
+ */
+static void __time_critical_func(rgbNextLine)(uint16_t y)
+{
+  static const uint16_t* currentSource = NULL;
+
+  uint32_t seq = displaySeq;
+  uint32_t slot = lineSlot(seq, y);
+  if (rgbLineSeq[slot] == seq)
+  {
+    currentSource = rgbLineSource[slot];
+  }
+  else
+  {
+    ++stats.lineUnderruns;
+  }
+  displaySeq = seq + 1;
+
+  const uint16_t* source = currentSource ? currentSource : rgbLineBuffers[0];
+  for (uint32_t i = 0; i < V_PIXEL_SCALE; ++i)
+  {
+    rgbLineBlocks[i] = source;
+  }
+  dma_channel_set_read_addr(rgbCtrlDmaChan, rgbLineBlocks, true);
+}
+
+/*
+ * stop the rgb dma and return the rgb state machine to the start of a line
+ * (only needed if the rgb side lost its place, eg. while parked)
+ */
+static void rgbResync()
+{
+  dma_channel_abort(rgbCtrlDmaChan);
+  dma_channel_abort(rgbDmaChan);
+  dma_channel_abort(rgbCtrlDmaChan);   // in case the abort chained
+
+  pio_sm_clear_fifos(VGA_PIO, RGB_SM);
+  pio_sm_restart(VGA_PIO, RGB_SM);
+  pio_sm_exec(VGA_PIO, RGB_SM, pio_encode_jmp(rgbProgOffset));
+  pio_interrupt_clear(VGA_PIO, vga_rgb_RGB_IRQ);
+}
+
+/*
+ * dma interrupt handler
+ *
+ * rgb: once per virtual line. sync: once per frame
+ */
+static void __time_critical_func(dmaIrqHandler)(void)
+{
+  static uint32_t rgbFrameLines = 0;
+
+  if (dma_hw->ints0 & (1u << rgbDmaChan))
+  {
+    dma_hw->ints0 = 1u << rgbDmaChan;
+
+    // the frame irq starts each frame's first line
+    if (++rgbFrameLines < V_VIRTUAL_PIXELS)
+    {
+      rgbNextLine(rgbFrameLines);
+    }
+  }
+
+  if (dma_hw->ints0 & (1u << syncDmaChan))
+  {
+    dma_hw->ints0 = 1u << syncDmaChan;
+
+    // end of frame. start the next one
+    dma_channel_set_read_addr(syncCtrlDmaChan, syncFrameBlocks, true);
+
+    if (rgbFrameLines < V_VIRTUAL_PIXELS)
+    {
+      rgbResync();
+      dma_hw->ints0 = 1u << rgbDmaChan;
+    }
+    rgbFrameLines = 0;
+
+    // realign with the frame (the irq may have been held off while parked)
+    displayFrameSeq += V_VIRTUAL_PIXELS;
+    displaySeq = displayFrameSeq;
+
+    rgbNextLine(0);
+  }
+}
+
+/*
+ * initialise the pio dma
+ */
+static void initDma()
+{
+  irq_set_exclusive_handler(DMA_IRQ_0, dmaIrqHandler);
+  irq_set_enabled(DMA_IRQ_0, true);
+
+  dma_channel_start(syncCtrlDmaChan);
+  rgbNextLine(0);
+}
+
+/*
+ * hold core1 in ram until released (flash is unavailable)
+ */
+static void __not_in_flash_func(vgaParkLoop)()
+{
+  parked = true;
+  while (parkRequested)
+  {
+    tight_loop_contents();
+  }
+  parked = false;
+}
+
+/*
+ * render (or fetch) virtual line y into a ring slot. returns false if the
+ * dma had already moved past the line
+ */
+static bool __time_critical_func(renderLine)(uint32_t seq, uint16_t y)
+{
+  uint32_t slot = lineSlot(seq, y);
+  const uint16_t* source = NULL;
+
+  // a prebuilt line needs no rendering at all
+  if (vgaParams.scanlineSourceFn)
+  {
+    source = vgaParams.scanlineSourceFn(y, &vgaParams.params);
+  }
+
+  if (!source)
+  {
+    vgaParams.scanlineFn(y, &vgaParams.params, rgbLineBuffers[slot]);
+    source = rgbLineBuffers[slot];
+  }
+
+  rgbLineSource[slot] = source;
+  __dmb();
+  rgbLineSeq[slot] = seq;
+
+  return (int32_t)(displaySeq - seq) <= 0;
+}
+
+/*
+ * wait for the helper to finish its line (core1)
+ */
+static inline void waitForHelper()
+{
+  while (helperBusy)
+  {
+    tight_loop_contents();
+  }
+}
+
+/*
+ * a frame has been rendered
+ */
+static void frameComplete(uint64_t* frameNumber)
+{
+  waitForHelper();
+
+#if VGA_DEADLINE_MONITOR
+  if (frameLateLines > stats.worstFrameLate ||
+     (frameLateLines == stats.worstFrameLate && frameLineMax > stats.worstFrameMax))
+  {
+    stats.worstFrame = *frameNumber;
+    stats.worstFrameLate = frameLateLines;
+    stats.worstFrameMax = frameLineMax;
+  }
+  frameLateLines = 0;
+  frameLineMax = 0;
+#endif
+
+  if (vgaParams.endOfFrameFn)
+  {
+    vgaParams.endOfFrameFn(*frameNumber);
+  }
+  ++*frameNumber;
+  ++stats.frames;
+
+  // the helper can start on the next frame
+  uint32_t seq = claimSeq;
+  readyFrameSeq = seq - (seq % V_VIRTUAL_PIXELS);
+}
+
+/*
+ * main vga loop
+ *
+ * messages from the dma irq come first. otherwise, render ahead until the
+ * line ring is full. the slot being displayed (displaySeq - 1) is never touched
+ */
+static void vgaLoop()
+{
+  uint64_t frameNumber = 0;
+  const uint32_t frameLines = V_VIRTUAL_PIXELS;
+
+#if VGA_DEADLINE_MONITOR
+  // free-running core1 systick for timing
+  systick_hw->rvr = 0x00ffffff;
+  systick_hw->csr = 0x5;    // enable, processor clock
+#endif
+
+  irq_set_exclusive_handler(SCANLINE_IRQ, scanlineIrqHandler);
+  irq_set_enabled(SCANLINE_IRQ, true);
+
+  // core0 can hold us in ram while it writes to flash
+  multicore_lockout_victim_init();
+
+  while (1)
+  {
+    if (parkRequested)
+    {
+      irq_set_enabled(SCANLINE_IRQ, false);
+      vgaParkLoop();
+      irq_set_enabled(SCANLINE_IRQ, true);
+      continue;
+    }
+
+    uint32_t shownSeq = displaySeq;
+
+    // too late for these lines. skip to the next one the irq can use
+    uint32_t save = spin_lock_blocking(renderLock);
+    uint32_t nextSeq = claimSeq;
+    if ((int32_t)(shownSeq - nextSeq) > 0)
+    {
+      claimSeq = shownSeq;
+    }
+    spin_unlock(renderLock, save);
+
+    if ((int32_t)(shownSeq - nextSeq) > 0)
+    {
+      uint32_t skipped = shownSeq - nextSeq;
+      stats.linesSkipped += skipped;
+      if ((nextSeq % frameLines) + skipped >= frameLines)
+      {
+        frameComplete(&frameNumber);
+      }
+    }
+
+    uint32_t tail = msgTail;
+    if (tail != msgHead)
+    {
+      __dmb();
+      uint32_t message = msgRing[tail & MSG_RING_MASK];
+      msgTail = tail + 1;
+
+      if ((message & END_OF_SCANLINE_MSG) != 0)
+      {
+        if (vgaParams.endOfScanlineFn)
+        {
+#if VGA_DEADLINE_MONITOR
+          uint32_t start = timingStart();
+          vgaParams.endOfScanlineFn();
+          timingEnd(start, stats.tickBudget, stats.tickHistogram, &stats.tickMax);
+#else
+          vgaParams.endOfScanlineFn();
+#endif
+        }
+      }
+      continue;
+    }
+
+    // claim the next line (the helper may have taken some)
+    save = spin_lock_blocking(renderLock);
+    uint32_t renderSeq = claimSeq;
+    uint16_t renderY = renderSeq % frameLines;
+    bool ringFull = !lineWritable(renderSeq, renderY, shownSeq);
+    if (!ringFull)
+    {
+      claimSeq = renderSeq + 1;
+    }
+    spin_unlock(renderLock, save);
+
+    // ring full. sleep until the irq has something for us
+    if (ringFull)
+    {
+      __wfe();
+      continue;
+    }
+
+#if VGA_DEADLINE_MONITOR
+    uint32_t start = timingStart();
+    bool onTime = renderLine(renderSeq, renderY);
+    uint32_t cycles = timingEnd(start, stats.lineBudget, stats.lineHistogram, &stats.lineMax);
+    if (cycles > frameLineMax) frameLineMax = cycles;
+    if (!onTime)
+    {
+      ++stats.lateLines;
+      ++frameLateLines;
+    }
+#else
+    renderLine(renderSeq, renderY);
+#endif
+
+    if (renderY == frameLines - 1)
+    {
+      frameComplete(&frameNumber);
+    }
+  }
+}
+
+/*
+ * render one line ahead of core1 if there's room and the line can be
+ * shared (call from core0 when it has time to spare). returns true if a
+ * line was rendered
+ */
+bool __time_critical_func(vgaHelpRender)()
+{
+  if (!renderLock || !vgaParams.helperScanlineFn) return false;
+
+  uint32_t save = spin_lock_blocking(renderLock);
+  uint32_t seq = claimSeq;
+  uint16_t y = seq % V_VIRTUAL_PIXELS;
+  bool claimed = !parkRequested &&
+                 (seq - readyFrameSeq) < V_VIRTUAL_PIXELS - 1 &&
+                 (int32_t)(seq - displaySeq) >= 0 &&
+                 lineWritable(seq, y, displaySeq) &&
+                 (!vgaParams.helperFilterFn || vgaParams.helperFilterFn(y, &vgaParams.params));
+  if (claimed)
+  {
+    claimSeq = seq + 1;
+    helperBusy = true;
+  }
+  spin_unlock(renderLock, save);
+
+  if (!claimed) return false;
+
+  uint32_t slot = lineSlot(seq, y);
+  vgaParams.helperScanlineFn(y, &vgaParams.params, rgbLineBuffers[slot]);
+
+  rgbLineSource[slot] = rgbLineBuffers[slot];
+  __dmb();
+  rgbLineSeq[slot] = seq;
+  helperBusy = false;
+  ++stats.helpedLines;
+
+  return true;
+}
+
+#ifdef VGA_FIXED_MODE
+/*
+ * do two sets of params describe the same frame?
+ */
+static bool sameGeometry(const VgaParams* a, const VgaParams* b)
+{
+  return a->pixelClockKHz == b->pixelClockKHz &&
+         a->hSyncParams.displayPixels == b->hSyncParams.displayPixels &&
+         a->hSyncParams.totalPixels == b->hSyncParams.totalPixels &&
+         a->vSyncParams.displayPixels == b->vSyncParams.displayPixels &&
+         a->vSyncParams.totalPixels == b->vSyncParams.totalPixels &&
+         a->hPixelScale == b->hPixelScale &&
+         a->vPixelScale == b->vPixelScale &&
+         a->hVirtualPixels == b->hVirtualPixels &&
+         a->vVirtualPixels == b->vVirtualPixels;
+}
+#endif
+
+/*
+ * initialise the vga. in a fixed mode build, params must describe that mode
+ */
+void vgaInit(VgaInitParams params)
+{
+  vgaParams = params;
+#ifdef VGA_FIXED_MODE
+  vgaParams.params = vgaGetParams(VGA_FIXED_MODE, VGA_FIXED_SCALE);
+  if (!sameGeometry(&params.params, &vgaParams.params))
+  {
+    panic("vgaInit: params don't match the fixed mode (%dx%d). see pico56_add_vga_library()",
+      vgaParams.params.hVirtualPixels, vgaParams.params.vVirtualPixels);
+  }
+#endif
+  renderLock = spin_lock_init(spin_lock_claim_unused(true));
+
+  vgaInitSync();
+  vgaInitRgb();
+
+  initDma();
+
+  pio_sm_set_enabled(VGA_PIO, SYNC_SM, true);
+  pio_sm_set_enabled(VGA_PIO, RGB_SM, true);
+
+  multicore_launch_core1(vgaLoop);
+}
+
+/*
+ * stop video output and park core1 in ram (eg. while writing to flash)
+ */
+void vgaPark()
+{
+  parkRequested = true;
+  __sev();
+  while (!parked)
+  {
+    tight_loop_contents();
+  }
+  irq_set_enabled(DMA_IRQ_0, false);
+}
+
+/*
+ * resume video output
+ */
+void vgaUnpark()
+{
+  irq_set_enabled(DMA_IRQ_0, true);
+  parkRequested = false;
+  while (parked)
+  {
+    tight_loop_contents();
+  }
+}
+
+/*
+ * the system clock for a pio clock multiple, or 0 if the pll can't hit it
+ * exactly (the pio dividers are whole numbers, so anything else would move
+ * the vga timing)
+ */
+uint32_t vgaClockMultipleKHz(uint32_t multiple)
+{
+  if (multiple < 1) return 0;
+
+  // the pio clock is the system clock over the current multiple
+  uint64_t clockHz = (uint64_t)clock_get_hz(clk_sys) * multiple;
+  uint32_t currentMultiple = vgaParams.params.pioDivider;
+  if (clockHz % ((uint64_t)currentMultiple * 1000)) return 0;
+
+  uint32_t clockKHz = clockHz / currentMultiple / 1000;
+
+  uint vcoFreq, postDiv1, postDiv2;
+  if (!check_sys_clock_khz(clockKHz, &vcoFreq, &postDiv1, &postDiv2)) return 0;
+
+  return clockKHz;
+}
+
+/*
+ * run the system clock at a multiple of the vga pio clock. the pio dividers
+ * change with it, so the sync and pixel timing (and the sync data) still
+ * hold. the output may glitch for a line or two while the pll relocks.
+ *
+ * clk_peri is moved to the usb pll (48MHz) so uart, spi and i2c rates don't
+ * follow the system clock. peripherals set up before the first change need
+ * their rates re-applied once. the pwm slices run from clk_sys and do move.
+ *
+ * returns the new clock, or 0 (clock unchanged) if the multiple can't be hit
+ */
+uint32_t vgaSetClockMultiple(uint32_t multiple)
+{
+  uint32_t sysClockKHz = vgaClockMultipleKHz(multiple);
+  if (!sysClockKHz || !set_sys_clock_khz(sysClockKHz, false)) return 0;
+
+  // set_sys_clock_khz() puts clk_peri back on clk_sys
+  clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB,
+                  VGA_PERI_CLOCK_HZ, VGA_PERI_CLOCK_HZ);
+
+  pio_sm_set_clkdiv_int_frac(VGA_PIO, SYNC_SM, multiple, 0);
+  pio_sm_set_clkdiv_int_frac(VGA_PIO, RGB_SM, multiple, 0);
+  pio_clkdiv_restart_sm_mask(VGA_PIO, (1 << SYNC_SM) | (1 << RGB_SM));
+
+  vgaParams.params.pioDivider = multiple;
+  updateBudgets(sysClockKHz);
+
+  return sysClockKHz;
+}
+
+VgaInitParams vgaCurrentParams()
+{
+  return vgaParams;
+}
+
+/*
+ * scanline ring, message and timing counters
+ */
+VgaStats vgaCurrentStats()
+{
+  VgaStats current = stats;
+  return current;
+}
+
+/*
+ * clear the timing counters (budgets are kept)
+ */
+void vgaResetStats()
+{
+  uint32_t lineBudget = stats.lineBudget;
+  uint32_t tickBudget = stats.tickBudget;
+  memset((void*)&stats, 0, sizeof(stats));
+  stats.lineBudget = lineBudget;
+  stats.tickBudget = tickBudget;
+}
+
+/*
+ * output a histogram as percentages of the budget
+ */
+static void printHistogram(const char* name, const uint32_t* histogram, uint32_t max, uint32_t budget)
+{
+  printf("%s: budget %d cycles, worst %d (%d%%)\n", name, budget, max, budget ? (max * 100 / budget) : 0);
+  for (int i = 0; i < VGA_TIMING_BUCKETS; ++i)
+  {
+    if (i == VGA_TIMING_BUCKETS - 1)
+    {
+      printf("  %3d%%+     : %d\n", i * 25, histogram[i]);
+    }
+    else
+    {
+      printf("  %3d-%3d%% : %d\n", i * 25, (i + 1) * 25, histogram[i]);
+    }
+  }
+}
+
+/*
+ * output the stats (stdio / usb serial)
+ */
+void vgaPrintStats()
+{
+  VgaStats current = vgaCurrentStats();
+
+  printf("\nvga: underruns %d, skipped %d, message overruns %d, helped %d\n",
+    current.lineUnderruns, current.linesSkipped, current.messageOverruns, current.helpedLines);
+
+#if VGA_DEADLINE_MONITOR
+  printf("vga: late lines %d. worst frame %lld (%d late, slowest line %d cycles)\n",
+    current.lateLines, current.worstFrame, current.worstFrameLate, current.worstFrameMax);
+  printHistogram("scanline", current.lineHistogram, current.lineMax, current.lineBudget);
+  printHistogram("end of scanline", current.tickHistogram, current.tickMax, current.tickBudget);
+#endif
 }
\ No newline at end of file
@@ -1,61 +1,143 @@
-/*
- * Project: pico-56 - vga
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-#pragma once
-
-#include <inttypes.h>
-#include <stdbool.h>
-
-typedef struct
-{
-  uint32_t displayPixels;
-  uint32_t frontPorchPixels;
-  uint32_t syncPixels;
-  uint32_t backPorchPixels;
-  uint32_t totalPixels;
-  float freqHz;
-  bool syncHigh;
-} VgaSyncParams;
-
-typedef struct
-{
-  uint32_t pixelClockKHz;
-  VgaSyncParams hSyncParams;
-  VgaSyncParams vSyncParams;
-  uint32_t hPixelScale;
-  uint32_t vPixelScale;
-  uint32_t hVirtualPixels;
-  uint32_t vVirtualPixels;
-  float pioDivider;
-  float pioFreqKHz;
-  float pioClocksPerPixel;
-  float pioClocksPerScaledPixel;
-} VgaParams;
-
-
-typedef void (*vgaScanlineRgbFn)(uint16_t y, VgaParams* params, uint16_t* pixels);
-typedef void (*vgaEndOfFrameFn)(uint64_t frameNumber);
-typedef void (*vgaEndOfScanlineFn)();
-
-extern uint32_t vgaMinimumPioClockKHz(VgaParams* params);
-
-typedef struct
-{
-  VgaParams params;
-  vgaScanlineRgbFn scanlineFn;
-  vgaEndOfFrameFn endOfFrameFn;
-  vgaEndOfScanlineFn endOfScanlineFn;
-} VgaInitParams;
-
-
-void vgaInit(VgaInitParams params);
-
-VgaInitParams vgaCurrentParams();
\ No newline at end of file
+/*
+ * Project: pico-56 - vga
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+// number of scanline buffers core1 can render ahead into (power of two, >= 2)
+#ifndef VGA_LINE_RING_SIZE
+#define VGA_LINE_RING_SIZE 4
+#endif
+
+// first virtual lines of each frame that get their own buffers, so core1 can
+// render them during vertical blanking (0 to disable)
+#ifndef VGA_PRERENDER_LINES
+#define VGA_PRERENDER_LINES 8
+#endif
+
+#define VGA_LINE_BUFFERS (VGA_LINE_RING_SIZE + VGA_PRERENDER_LINES)
+
+// time each scanline callback on core1 against its budget
+#ifndef VGA_DEADLINE_MONITOR
+#define VGA_DEADLINE_MONITOR 1
+#endif
+
+#define VGA_TIMING_BUCKETS 8    // histogram buckets. quarters of the budget (the last is 175%+)
+
+typedef struct
+{
+  uint32_t displayPixels;
+  uint32_t frontPorchPixels;
+  uint32_t syncPixels;
+  uint32_t backPorchPixels;
+  uint32_t totalPixels;
+  float freqHz;
+  bool syncHigh;
+} VgaSyncParams;
+
+typedef struct
+{
+  uint32_t pixelClockKHz;
+  VgaSyncParams hSyncParams;
+  VgaSyncParams vSyncParams;
+  uint32_t hPixelScale;
+  uint32_t vPixelScale;
+  uint32_t hVirtualPixels;
+  uint32_t vVirtualPixels;
+  float pioDivider;
+  float pioFreqKHz;
+  float pioClocksPerPixel;
+  float pioClocksPerScaledPixel;
+} VgaParams;
+
+
+typedef void (*vgaScanlineRgbFn)(uint16_t y, VgaParams* params, uint16_t* pixels);
+typedef const uint16_t* (*vgaScanlineSourceFn)(uint16_t y, VgaParams* params);
+typedef void (*vgaEndOfFrameFn)(uint64_t frameNumber);
+typedef void (*vgaEndOfScanlineFn)();
+typedef bool (*vgaScanlineFilterFn)(uint16_t y, VgaParams* params);
+
+extern uint32_t vgaMinimumPioClockKHz(VgaParams* params);
+
+typedef struct
+{
+  VgaParams params;
+  vgaScanlineRgbFn scanlineFn;
+  vgaScanlineSourceFn scanlineSourceFn;   // optional. return a prebuilt line (or NULL to use scanlineFn)
+  vgaEndOfFrameFn endOfFrameFn;
+  vgaEndOfScanlineFn endOfScanlineFn;
+  vgaScanlineRgbFn helperScanlineFn;      // optional. render a line on core0 (see vgaHelpRender)
+  vgaScanlineFilterFn helperFilterFn;     // optional. can core0 render line y right now? (called under a lock - keep it short)
+} VgaInitParams;
+
+typedef struct
+{
+  uint32_t lineUnderruns;     // lines repeated because they weren't rendered in time
+  uint32_t linesSkipped;      // lines core1 gave up on (already passed by the beam)
+  uint32_t messageOverruns;   // end of scanline messages dropped (core1 too far behind). each is a missed endOfScanlineFn call
+  uint32_t frames;            // frames rendered
+
+  // deadline monitor (VGA_DEADLINE_MONITOR). times are in cpu cycles
+  uint32_t lineBudget;        // one virtual line (scanlineFn)
+  uint32_t tickBudget;        // one display line (endOfScanlineFn)
+  uint32_t lineMax;
+  uint32_t tickMax;
+  uint32_t lineHistogram[VGA_TIMING_BUCKETS];
+  uint32_t tickHistogram[VGA_TIMING_BUCKETS];
+  uint32_t lateLines;         // finished after the dma had already moved past the line
+  uint64_t worstFrame;        // frame with the most late lines (then the slowest line)
+  uint32_t worstFrameLate;
+  uint32_t worstFrameMax;
+  uint32_t busyCycles;        // total time in the callbacks (wraps)
+  uint32_t helpedLines;       // lines rendered by core0 (vgaHelpRender)
+} VgaStats;
+
+
+/*
+ * start the vga. a library built for a fixed mode (pico56_add_vga_library
+ * with a mode and scale) panics if params describe a different frame
+ */
+void vgaInit(VgaInitParams params);
+
+/*
+ * set the system clock as close as we can get to clockKHz. returns the actual clock
+ */
+uint32_t vgaSetSysClockKHz(uint32_t clockKHz);
+
+/*
+ * after vgaInit, the system clock for a multiple of the vga pio clock
+ * (params.pioDivider is the current multiple). 0 if it can't be hit exactly
+ */
+uint32_t vgaClockMultipleKHz(uint32_t multiple);
+
+/*
+ * after vgaInit, run the system clock at a multiple of the vga pio clock.
+ * clk_peri moves to the usb pll (48MHz). returns the new clock, or 0 if the
+ * multiple can't be hit exactly (nothing changes)
+ */
+uint32_t vgaSetClockMultiple(uint32_t multiple);
+
+VgaInitParams vgaCurrentParams();
+
+/*
+ * render one line ahead of core1 if there's room and the line can be shared
+ * (call from core0 when it has time to spare). returns true if a line was rendered
+ */
+bool vgaHelpRender();
+
+void vgaPark();
+void vgaUnpark();
+
+VgaStats vgaCurrentStats();
+void vgaResetStats();
+void vgaPrintStats();
\ No newline at end of file
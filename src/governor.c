@@ -0,0 +1,149 @@
+/*
+ * Project: pico-56 - system clock governor
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "governor.h"
+#include "vga.h"
+#include "sdcard.h"
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+
+#include <stdio.h>
+
+ /*
+  * the system clock is always a whole multiple of the vga pio clock, so a
+  * change is just new pio dividers (multiples the pll can't hit exactly are
+  * skipped). each period we measure the load on both cores (core0: time
+  * emulating, core1: time in the scanline callbacks):
+  *
+  *   - any late lines or dropped scanline messages, or either core over
+  *     GOVERNOR_MAX_LOAD: step up a multiple straight away
+  *   - both cores would still be under GOVERNOR_TARGET_LOAD one multiple
+  *     down for GOVERNOR_STEADY_PERIODS in a row: step down a multiple
+  *
+  * the period after a change is ignored (the switch itself can cost a line)
+  */
+
+#define GOVERNOR_PERIOD_US       500000
+#define GOVERNOR_MIN_CLOCK_KHZ   100000   // never go below this
+#define GOVERNOR_MAX_LOAD        85       // percent
+#define GOVERNOR_TARGET_LOAD     70       // percent
+#define GOVERNOR_STEADY_PERIODS  4
+
+static uint32_t minMultiple = 1;
+static uint32_t maxMultiple = 1;
+static uint32_t multiple = 1;
+static uint32_t clockKHz = 0;
+
+/*
+ * the next multiple (step -1 or 1) the pll can hit exactly, or 0 if none
+ */
+static uint32_t nextMultiple(int step)
+{
+  for (uint32_t m = multiple + step; m >= minMultiple && m <= maxMultiple; m += step)
+  {
+    if (vgaClockMultipleKHz(m)) return m;
+  }
+  return 0;
+}
+
+/*
+ * change the clock multiple. returns false if the clock didn't change
+ */
+static bool setMultiple(uint32_t newMultiple)
+{
+  uint32_t newClockKHz = newMultiple ? vgaSetClockMultiple(newMultiple) : 0;
+  if (!newClockKHz) return false;
+
+  multiple = newMultiple;
+  clockKHz = newClockKHz;
+
+  // clk_peri is now on the usb pll. the spi rate was set against the old one
+  sdcardClockChanged();
+
+  printf("governor: system clock %d KHz\n", clockKHz);
+  return true;
+}
+
+/*
+ * start governing the system clock (after vgaInit)
+ */
+void governorInit()
+{
+  VgaParams params = vgaCurrentParams().params;
+  uint32_t pioClockKHz = params.pioFreqKHz;
+
+  maxMultiple = params.pioDivider;
+  minMultiple = (GOVERNOR_MIN_CLOCK_KHZ + pioClockKHz - 1) / pioClockKHz;
+  if (minMultiple < 1) minMultiple = 1;
+  if (minMultiple > maxMultiple) minMultiple = maxMultiple;
+
+  multiple = maxMultiple;
+  clockKHz = clock_get_hz(clk_sys) / 1000;
+}
+
+/*
+ * measure both cores and step the clock up or down
+ */
+void governorUpdate(uint64_t core0BusyUs)
+{
+  static uint64_t lastTime = 0;
+  static uint64_t lastBusyUs = 0;
+  static VgaStats lastStats;
+  static uint32_t steadyPeriods = 0;
+  static bool settling = false;
+
+  uint64_t now = time_us_64();
+  if (now - lastTime < GOVERNOR_PERIOD_US) return;
+
+  VgaStats stats = vgaCurrentStats();
+
+  if (lastTime && !settling)
+  {
+    uint32_t elapsedUs = now - lastTime;
+
+    uint32_t core0Load = (core0BusyUs - lastBusyUs) * 100 / elapsedUs;
+    uint32_t core1Load = (uint64_t)(stats.busyCycles - lastStats.busyCycles) * 100000 / ((uint64_t)elapsedUs * clockKHz);
+    uint32_t load = core0Load > core1Load ? core0Load : core1Load;
+
+    uint32_t down = 0;
+    bool slipping = (stats.lateLines != lastStats.lateLines) ||
+                    (stats.messageOverruns != lastStats.messageOverruns) ||
+                    (stats.linesSkipped != lastStats.linesSkipped);
+
+    if ((slipping || load > GOVERNOR_MAX_LOAD) && multiple < maxMultiple)
+    {
+      settling = setMultiple(nextMultiple(1));
+      steadyPeriods = 0;
+    }
+    else if (!slipping && (down = nextMultiple(-1)) &&
+             load * multiple / down < GOVERNOR_TARGET_LOAD)
+    {
+      if (++steadyPeriods >= GOVERNOR_STEADY_PERIODS)
+      {
+        settling = setMultiple(down);
+        steadyPeriods = 0;
+      }
+    }
+    else
+    {
+      steadyPeriods = 0;
+    }
+  }
+  else
+  {
+    settling = false;
+  }
+
+  lastTime = time_us_64();
+  lastBusyUs = core0BusyUs;
+  lastStats = vgaCurrentStats();
+}
@@ -0,0 +1,27 @@
+/*
+ * Project: pico-56 - system clock governor
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+/*
+ * start governing the system clock (after vgaInit). the clock stays a multiple
+ * of the vga pio clock, up to the current clock
+ */
+void governorInit();
+
+/*
+ * call regularly from core0 with the total time core0 has spent emulating
+ * (not waiting). measures both cores and steps the clock up or down
+ */
+void governorUpdate(uint64_t core0BusyUs);
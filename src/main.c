@@ -1,32 +1,50 @@
-/*
- * Project: pico-56
- *
- * Copyright (c) 2023 Troy Schrapel
- *
- * This code is licensed under the MIT license
- *
- * https://github.com/visrealm/pico-56
- *
- */
-
-#include "bus.h"
-#include "boot-menu.h"
-
-#include "pico/stdlib.h"
-
-int main(void)
-{
-  // initialize stdio over usb serial
-  stdio_init_all();
-
-  // initialize the bus (all devices)
-  busInit();
-
-  // run  the PICO-56 boot menu
-  runBootMenu();
-
-  // it's go time!
-  busMainLoop();
-
-  return 0;
-}
+/*
+ * Project: pico-56
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "bus.h"
+#include "boot-menu.h"
+#include "settings.h"
+#include "replay.h"
+#include "tms9918.h"
+
+#include "pico/stdlib.h"
+
+int main(void)
+{
+  // initialize stdio over usb serial
+  stdio_init_all();
+
+  // display mode (from the boot menu settings)
+  const Settings* settings = settingsCurrent();
+  tmsSetVgaMode(settings->vgaMode, settings->pixelScale);
+
+  // initialize the bus (all devices)
+  busInit();
+
+  // run  the PICO-56 boot menu
+  BootOptions options = { 0 };
+  runBootMenu(&options);
+
+  // input record / playback
+  if (options.recordInput)
+  {
+    replayStart(REPLAY_RECORD, options.replayFile, settings->vgaMode, settings->pixelScale);
+  }
+  else if (options.replayInput)
+  {
+    replayStart(REPLAY_PLAYBACK, options.replayFile, settings->vgaMode, settings->pixelScale);
+  }
+
+  // it's go time!
+  busMainLoop();
+
+  return 0;
+}
@@ -0,0 +1,260 @@
+/*
+ * Project: pico-56 - input record / replay
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "replay.h"
+
+#include "sdcard.h"
+
+#include "pico/stdlib.h"
+
+#include <stdio.h>
+#include <string.h>
+
+ /*
+  * the log is plain text. a header line with the display mode, then one
+  * input per line (all values in hex):
+  *
+  *   mode <vga mode> <pixel scale>
+  *   <cycle> <type> <value>
+  *
+  * when logging to usb serial, each line is prefixed with REPLAY_USB_PREFIX
+  * so it can be picked out of the uart output on the host
+  */
+
+#define REPLAY_USB_PREFIX   "@in "
+#define REPLAY_MODE_TAG     "mode"
+#define REPLAY_BUFFER_SIZE  512
+#define REPLAY_MAX_LINE     32
+#define REPLAY_LOOKAHEAD    64    // events read ahead of the current cycle
+
+static ReplayMode mode = REPLAY_OFF;
+static FIL logFile;
+static bool logToFile = false;
+
+static char buffer[REPLAY_BUFFER_SIZE];
+static int bufferPos = 0;
+static int bufferLen = 0;
+
+// events read from the log but not yet applied (in log order). inputs of
+// different types are consumed independently (eg. uart bytes wait for the
+// guest to read them), so one type mustn't hold up the others
+static ReplayEvent pending[REPLAY_LOOKAHEAD];
+static int pendingCount = 0;
+static bool logEnded = false;
+
+/*
+ * write buffered log lines to the sd card
+ */
+void replayFlush()
+{
+  if (mode == REPLAY_RECORD && logToFile && bufferPos)
+  {
+    uint bw = 0;
+    f_write(&logFile, buffer, bufferPos, &bw);
+    f_sync(&logFile);
+    bufferPos = 0;
+  }
+}
+
+/*
+ * next character of the log (playback). returns -1 at end of file
+ */
+static int readChar()
+{
+  if (bufferPos == bufferLen)
+  {
+    uint br = 0;
+    if (f_read(&logFile, buffer, sizeof(buffer), &br) != FR_OK) br = 0;
+    bufferPos = 0;
+    bufferLen = br;
+    if (br == 0) return -1;
+  }
+  return buffer[bufferPos++];
+}
+
+/*
+ * read a hex value terminated by whitespace
+ */
+static bool readHex(uint64_t* value)
+{
+  int c = readChar();
+  while (c == ' ' || c == '\r' || c == '\n') c = readChar();
+
+  *value = 0;
+  int digits = 0;
+  for (; c >= 0; c = readChar(), ++digits)
+  {
+    if (c >= '0' && c <= '9') *value = (*value << 4) | (c - '0');
+    else if (c >= 'a' && c <= 'f') *value = (*value << 4) | (c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F') *value = (*value << 4) | (c - 'A' + 10);
+    else break;
+  }
+  return digits != 0;
+}
+
+/*
+ * read an expected word (after any whitespace)
+ */
+static bool readTag(const char* tag)
+{
+  int c = readChar();
+  while (c == ' ' || c == '\r' || c == '\n') c = readChar();
+
+  for (; *tag; ++tag, c = readChar())
+  {
+    if (c != *tag) return false;
+  }
+  return c == ' ';
+}
+
+/*
+ * read the next event from the log
+ */
+static bool readEvent(ReplayEvent* event)
+{
+  uint64_t cycle, type, value;
+  if (!readHex(&cycle) || !readHex(&type) || !readHex(&value)) return false;
+
+  event->cycle = cycle;
+  event->type = (ReplayInput)type;
+  event->value = value;
+  return true;
+}
+
+/*
+ * start recording to (or playing back from) fileName
+ */
+bool replayStart(ReplayMode newMode, const char* fileName, uint32_t vgaMode, uint32_t pixelScale)
+{
+  mode = REPLAY_OFF;
+  bufferPos = bufferLen = 0;
+  pendingCount = 0;
+  logEnded = false;
+
+  switch (newMode)
+  {
+    case REPLAY_RECORD:
+      logToFile = f_open(&logFile, fileName, FA_CREATE_ALWAYS | FA_WRITE) == FR_OK;
+      printf("Recording input to %s\n", logToFile ? fileName : "usb");
+      if (logToFile)
+      {
+        bufferPos = snprintf(buffer, REPLAY_MAX_LINE, REPLAY_MODE_TAG " %x %x\n", vgaMode, pixelScale);
+      }
+      else
+      {
+        printf(REPLAY_USB_PREFIX REPLAY_MODE_TAG " %x %x\n", vgaMode, pixelScale);
+      }
+      break;
+
+    case REPLAY_PLAYBACK:
+      if (f_open(&logFile, fileName, FA_OPEN_EXISTING | FA_READ) != FR_OK)
+      {
+        printf("Unable to open %s\n", fileName);
+        return false;
+      }
+      logToFile = true;
+      {
+        uint64_t logVgaMode, logPixelScale;
+        if (!readTag(REPLAY_MODE_TAG) || !readHex(&logVgaMode) || !readHex(&logPixelScale) ||
+            logVgaMode != vgaMode || logPixelScale != pixelScale)
+        {
+          printf("Unable to replay %s: recorded in a different display mode\n", fileName);
+          f_close(&logFile);
+          return false;
+        }
+      }
+      printf("Replaying input from %s\n", fileName);
+      break;
+
+    default:
+      return true;
+  }
+
+  mode = newMode;
+  return true;
+}
+
+/*
+ * current mode
+ */
+ReplayMode replayMode()
+{
+  return mode;
+}
+
+/*
+ * log an input applied at the given cycle
+ */
+void replayRecord(uint64_t cycle, ReplayInput type, uint8_t value)
+{
+  if (mode != REPLAY_RECORD) return;
+
+  if (!logToFile)
+  {
+    printf(REPLAY_USB_PREFIX "%llx %x %x\n", cycle, type, value);
+    return;
+  }
+
+  if (bufferPos > REPLAY_BUFFER_SIZE - REPLAY_MAX_LINE)
+  {
+    replayFlush();
+  }
+
+  bufferPos += snprintf(buffer + bufferPos, REPLAY_MAX_LINE, "%llx %x %x\n", cycle, type, value);
+}
+
+/*
+ * read ahead until every event due by the given cycle is pending (or the
+ * lookahead is full)
+ */
+static void readAhead(uint64_t cycle)
+{
+  while (!logEnded && pendingCount < REPLAY_LOOKAHEAD &&
+         (pendingCount == 0 || pending[pendingCount - 1].cycle <= cycle))
+  {
+    if (readEvent(&pending[pendingCount]))
+    {
+      ++pendingCount;
+    }
+    else
+    {
+      logEnded = true;
+      f_close(&logFile);
+    }
+  }
+}
+
+/*
+ * pop the next logged input of a type in typeMask if it's due
+ */
+bool replayNext(uint64_t cycle, uint32_t typeMask, ReplayEvent* event)
+{
+  if (mode != REPLAY_PLAYBACK) return false;
+
+  readAhead(cycle);
+
+  for (int i = 0; i < pendingCount; ++i)
+  {
+    if (!(typeMask & REPLAY_INPUT_MASK(pending[i].type))) continue;
+    if (pending[i].cycle > cycle) return false;
+
+    *event = pending[i];
+    --pendingCount;
+    memmove(pending + i, pending + i + 1, (pendingCount - i) * sizeof(ReplayEvent));
+
+    if (logEnded && pendingCount == 0)
+    {
+      printf("Replay complete\n");
+    }
+    return true;
+  }
+  return false;
+}
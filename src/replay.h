@@ -0,0 +1,66 @@
+/*
+ * Project: pico-56 - input record / replay
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+typedef enum
+{
+  REPLAY_OFF,
+  REPLAY_RECORD,
+  REPLAY_PLAYBACK,
+} ReplayMode;
+
+typedef enum
+{
+  REPLAY_INPUT_KBD,     // ps/2 scancode
+  REPLAY_INPUT_NES1,    // nes controller 1 state
+  REPLAY_INPUT_NES2,    // nes controller 2 state
+  REPLAY_INPUT_UART,    // uart rx byte
+} ReplayInput;
+
+#define REPLAY_INPUT_MASK(t) (1 << (t))
+
+typedef struct
+{
+  uint64_t cycle;       // emulated cpu cycle the input was applied
+  ReplayInput type;
+  uint8_t value;
+} ReplayEvent;
+
+/*
+ * start recording to (or playing back from) fileName. when recording and the
+ * file can't be created, the log is written to usb serial instead.
+ *
+ * timing (and so the replay) depends on the display mode, so it is recorded
+ * in the log and playback refuses a log from a different mode
+ */
+bool replayStart(ReplayMode mode, const char* fileName, uint32_t vgaMode, uint32_t pixelScale);
+
+ReplayMode replayMode();
+
+/*
+ * log an input applied at the given cycle (record mode)
+ */
+void replayRecord(uint64_t cycle, ReplayInput type, uint8_t value);
+
+/*
+ * write any buffered log lines out (record mode)
+ */
+void replayFlush();
+
+/*
+ * pop the next logged input if it is due by the given cycle and its type
+ * is in typeMask (playback mode)
+ */
+bool replayNext(uint64_t cycle, uint32_t typeMask, ReplayEvent* event);
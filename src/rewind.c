@@ -0,0 +1,306 @@
+/*
+ * Project: pico-56 - rewind buffer
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#include "rewind.h"
+
+#include "pico/stdlib.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+ /*
+  * each frame is stored as the xor of the new state against the previous
+  * state, run-length encoded as a sequence of tokens:
+  *
+  * +-------------------------+-------------------------+
+  * |         31 - 16         |         15 - 0          |
+  * |    unchanged words      |      literal words      |
+  * +-------------------------+-------------------------+
+  *
+  * each token is followed by its literal (xor) words. applying a record to
+  * the current state gives the state of the frame before it
+  */
+
+#define REWIND_MAX_FRAMES   512
+#define REWIND_MAX_RUN      0xffff
+
+typedef struct
+{
+  uint32_t offset;  // start of record in history (words)
+  uint32_t length;  // length of record (words)
+} RewindRecord;
+
+static uint32_t* state = NULL;        // most recent snapshot
+static size_t stateWords = 0;
+
+static uint32_t* history = NULL;      // ring of delta records
+static size_t historyWords = 0;
+static size_t maxRecordWords = 0;
+
+static RewindRecord records[REWIND_MAX_FRAMES];
+static int oldestRecord = 0;
+static int recordCount = 0;
+static bool haveState = false;
+
+/* encoder state for the current frame */
+static size_t statePos = 0;
+static size_t writePos = 0;
+static size_t recordStart = 0;
+static size_t tokenPos = 0;
+static uint32_t skipRun = 0;
+static uint32_t literalRun = 0;
+static bool overflow = false;
+
+/*
+ * allocate the reference state and history ring
+ */
+bool rewindInit(size_t words, size_t historyBytes)
+{
+  state = malloc(words * sizeof(uint32_t));
+  history = malloc(historyBytes);
+
+  if (!state || !history)
+  {
+    free(state); state = NULL;
+    free(history); history = NULL;
+    return false;
+  }
+
+  stateWords = words;
+  historyWords = historyBytes / sizeof(uint32_t);
+  maxRecordWords = historyWords / 4;
+  memset(state, 0, stateWords * sizeof(uint32_t));
+
+  oldestRecord = 0;
+  recordCount = 0;
+  haveState = false;
+  return true;
+}
+
+/*
+ * index of the newest record
+ */
+static inline int newestRecord()
+{
+  return (oldestRecord + recordCount - 1) % REWIND_MAX_FRAMES;
+}
+
+/*
+ * do two word ranges overlap?
+ */
+static inline bool overlaps(size_t start1, size_t len1, size_t start2, size_t len2)
+{
+  return start1 < (start2 + len2) && start2 < (start1 + len1);
+}
+
+/*
+ * emit a word to the current record
+ */
+static inline void emit(uint32_t word)
+{
+  if (writePos < recordStart + maxRecordWords)
+  {
+    history[writePos] = word;
+  }
+  else
+  {
+    overflow = true;
+  }
+  ++writePos;
+}
+
+/*
+ * close the current literal run (if any)
+ */
+static inline void closeToken()
+{
+  if (literalRun && !overflow)
+  {
+    history[tokenPos] = (skipRun << 16) | literalRun;
+  }
+  skipRun = 0;
+  literalRun = 0;
+}
+
+/*
+ * begin a new frame
+ */
+void rewindBeginFrame()
+{
+  statePos = 0;
+  skipRun = 0;
+  literalRun = 0;
+  overflow = false;
+
+  if (!state) return;
+
+  // we need room for a worst-case record in one contiguous run
+  writePos = recordCount ? (records[newestRecord()].offset + records[newestRecord()].length) : 0;
+  if (writePos + maxRecordWords > historyWords) writePos = 0;
+
+  // evict the oldest frames we're about to overwrite
+  while (recordCount && overlaps(writePos, maxRecordWords, records[oldestRecord].offset, records[oldestRecord].length))
+  {
+    oldestRecord = (oldestRecord + 1) % REWIND_MAX_FRAMES;
+    --recordCount;
+  }
+
+  if (recordCount == REWIND_MAX_FRAMES)
+  {
+    oldestRecord = (oldestRecord + 1) % REWIND_MAX_FRAMES;
+    --recordCount;
+  }
+
+  recordStart = writePos;
+}
+
+/*
+ * add state to the current frame
+ */
+void __not_in_flash_func(rewindWrite)(const uint32_t* words, size_t count)
+{
+  if (!state) return;
+  if (statePos + count > stateWords) count = stateWords - statePos;
+
+  uint32_t* ref = state + statePos;
+  statePos += count;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    uint32_t delta = ref[i] ^ words[i];
+    if (delta == 0)
+    {
+      if (literalRun) closeToken();
+      if (++skipRun == REWIND_MAX_RUN)
+      {
+        // an empty token to flush a long unchanged run
+        literalRun = 0;
+        tokenPos = writePos;
+        emit(skipRun << 16);
+        skipRun = 0;
+      }
+      continue;
+    }
+
+    ref[i] = words[i];
+
+    if (literalRun == 0)
+    {
+      tokenPos = writePos;
+      emit(0);
+    }
+    emit(delta);
+
+    if (++literalRun == REWIND_MAX_RUN) closeToken();
+  }
+}
+
+/*
+ * skip state known to be unchanged since the last frame
+ */
+void __not_in_flash_func(rewindSkip)(size_t count)
+{
+  if (!state) return;
+  if (statePos + count > stateWords) count = stateWords - statePos;
+
+  statePos += count;
+  if (literalRun) closeToken();
+
+  while (count)
+  {
+    uint32_t run = REWIND_MAX_RUN - skipRun;
+    if (run > count) run = count;
+    skipRun += run;
+    count -= run;
+
+    if (skipRun == REWIND_MAX_RUN)
+    {
+      // an empty token to flush a long unchanged run
+      tokenPos = writePos;
+      emit(skipRun << 16);
+      skipRun = 0;
+    }
+  }
+}
+
+/*
+ * complete the current frame
+ */
+void rewindEndFrame()
+{
+  if (!state) return;
+
+  closeToken();
+
+  // the very first frame has nothing to rewind to
+  if (!haveState)
+  {
+    haveState = true;
+    return;
+  }
+
+  // a record that doesn't fit breaks the chain. start again from here
+  if (overflow)
+  {
+    recordCount = 0;
+    return;
+  }
+
+  if (writePos == recordStart) return;  // nothing changed
+
+  ++recordCount;
+  records[newestRecord()].offset = recordStart;
+  records[newestRecord()].length = writePos - recordStart;
+}
+
+/*
+ * step back one frame
+ */
+bool rewindStepBack()
+{
+  if (!state || recordCount == 0) return false;
+
+  RewindRecord* rec = &records[newestRecord()];
+  const uint32_t* src = history + rec->offset;
+  const uint32_t* end = src + rec->length;
+
+  uint32_t* ref = state;
+  while (src < end)
+  {
+    uint32_t token = *src++;
+    ref += token >> 16;
+
+    uint32_t literals = token & 0xffff;
+    while (literals--)
+    {
+      *ref++ ^= *src++;
+    }
+  }
+
+  --recordCount;
+  return true;
+}
+
+/*
+ * the current reference state
+ */
+const uint32_t* rewindState()
+{
+  return state;
+}
+
+/*
+ * number of frames we can step back
+ */
+int rewindFrameCount()
+{
+  return recordCount;
+}
@@ -0,0 +1,44 @@
+/*
+ * Project: pico-56 - rewind buffer
+ *
+ * Copyright (c) 2023 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/pico-56
+ *
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * allocate the reference state (stateWords) and history ring (historyBytes)
+ */
+bool rewindInit(size_t stateWords, size_t historyBytes);
+
+/*
+ * snapshot a frame. call rewindWrite() with the entire machine state
+ * (in the same order each frame) between begin and end
+ */
+void rewindBeginFrame();
+void rewindWrite(const uint32_t* words, size_t count);
+void rewindEndFrame();
+
+/*
+ * skip state known to be unchanged since the last frame (as if the same
+ * words were written again)
+ */
+void rewindSkip(size_t count);
+
+/*
+ * step back one frame. the previous state is then available from rewindState()
+ */
+bool rewindStepBack();
+
+const uint32_t* rewindState();
+
+int rewindFrameCount();
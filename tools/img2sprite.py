@@ -0,0 +1,247 @@
+# img2sprite.py
+#
+# Convert image files into span-encoded sprites (see vga-sprite.h)
+#
+# Copyright (c) 2023 Troy Schrapel
+#
+# This code is licensed under the MIT license
+#
+# https://github.com/visrealm/pico-56
+#
+#
+
+import os
+import sys
+import glob
+import re
+import argparse
+import datetime
+from PIL import Image
+
+# span header: type in the top two bits, length in the rest
+SPAN_SKIP = 0
+SPAN_OPAQUE = 1
+SPAN_BLEND = 2
+SPAN_TYPE_SHIFT = 14
+SPAN_MAX_LENGTH = (1 << SPAN_TYPE_SHIFT) - 1
+
+ALPHA_LEVELS = 16
+
+
+def main() -> int:
+    """
+    main program entry-point
+    """
+    parser = argparse.ArgumentParser(
+        description='Convert images into span-encoded sprites for use with the PICO-56.',
+        epilog="GitHub: https://github.com/visrealm/pico-56")
+    parser.add_argument('-v', '--verbose',
+                        help='verbose output', action='store_true')
+    parser.add_argument(
+        '-p', '--prefix', help='sprite variable prefix', default='')
+    parser.add_argument(
+        '-o', '--out', help='output file (a header of the same name is also generated)', required=True)
+    parser.add_argument('-r', '--ram', nargs='+', default='',
+                        help='input file(s) to store in Pi Pico RAM - can use wildcards')
+    parser.add_argument('-i', '--in', nargs='+', default='',
+                        help='input file(s) to store in Pi Pico ROM - can use wildcards')
+    args = vars(parser.parse_args())
+
+    inRomFileNames = []
+    inRamFileNames = []
+
+    for inRomGlob in args['in']:
+        inRomFileNames.extend(sorted(glob.glob(inRomGlob)))
+
+    for inRamGlob in args['ram']:
+        inRamFileNames.extend(sorted(glob.glob(inRamGlob)))
+
+    outSourceFileName = args['out']
+    outHeaderFileName = os.path.splitext(outSourceFileName)[0] + ".h"
+
+    with open(outSourceFileName, "w") as outSourceFile, open(outHeaderFileName, "w") as outHeaderFile:
+        outSourceFile.write(getFileHeader(
+            outSourceFileName, inRomFileNames, inRamFileNames, args, isHeaderFile=False))
+        outHeaderFile.write(getFileHeader(
+            outHeaderFileName, inRomFileNames, inRamFileNames, args, isHeaderFile=True))
+
+        for infile in inRamFileNames:
+            processImageFile(infile, outSourceFile, outHeaderFile, args, inRam=True)
+
+        for infile in inRomFileNames:
+            processImageFile(infile, outSourceFile, outHeaderFile, args, inRam=False)
+
+        outHeaderFile.write("\n#endif")
+
+    print(sys.argv[0] + " generated sprites in " +
+          os.path.join(os.getcwd(), outSourceFileName) + " from (" +
+          ", ".join(os.path.split(f)[1] for f in inRamFileNames + inRomFileNames) + ")")
+
+    return 0
+
+
+def getFileHeader(fileName, romFileList, ramFileList, args, isHeaderFile) -> str:
+    """
+    write the header at the top of the .c/.h file
+    """
+    timestamp = datetime.datetime.now()
+    hdrText = (
+        f"/*\n"
+        f" * Sprite file generated by {os.path.split(sys.argv[0])[1]}\n"
+        f" * Copyright (c) {timestamp.strftime('%Y')} Troy Schrapel\n"
+        f" *\n"
+        f" * Generated using the following command:\n"
+        f" *   > cd {os.getcwd()}\n"
+        f" *   > python3 {' '.join(sys.argv[:])}\n"
+        f" *\n"
+        f" * Timestamp: {timestamp.strftime('%Y-%m-%d %H:%M:%S')}\n"
+        f" *\n"
+        f" * Contains the following sprites:\n"
+        f" *\n")
+
+    for infile in ramFileList:
+        hdrText += f" * - {os.path.split(infile)[1]} (RAM)\n"
+
+    for infile in romFileList:
+        hdrText += f" * - {os.path.split(infile)[1]}\n"
+
+    hdrText += " */\n\n"
+
+    if isHeaderFile:
+        baseName = args['prefix'] + "_" + os.path.basename(fileName)
+        sanitizedFile = re.sub('[^0-9a-zA-Z]+', '_', baseName.upper())
+        hdrText += f"#ifndef _{sanitizedFile}\n"
+        hdrText += f"#define _{sanitizedFile}\n\n"
+    else:
+        hdrText += "#include \"pico.h\"\n"
+    hdrText += "#include \"vga-sprite.h\""
+    return hdrText
+
+
+def encodeBGR12(r, g, b) -> int:
+    """
+    encode 8-bit r, g, b values as 12-bit 0xbgr
+    """
+    return ((b >> 4) << 8) | ((g >> 4) << 4) | (r >> 4)
+
+
+def encodeBlend(r, g, b, weight) -> int:
+    """
+    encode a blended pixel: premultiplied 0xbgr with the weight of the
+    background (16 - alpha, 1 to 15) in the top nibble
+    """
+    alpha = ALPHA_LEVELS - weight
+    pr = ((r >> 4) * alpha) >> 4
+    pg = ((g >> 4) * alpha) >> 4
+    pb = ((b >> 4) * alpha) >> 4
+    return (weight << 12) | (pb << 8) | (pg << 4) | pr
+
+
+def spanHeader(spanType, length) -> int:
+    return (spanType << SPAN_TYPE_SHIFT) | length
+
+
+def pixelAlpha(a) -> int:
+    """
+    quantise 8-bit alpha to ALPHA_LEVELS (0 is transparent, ALPHA_LEVELS opaque)
+    """
+    return (a * ALPHA_LEVELS + 127) // 255
+
+
+def pixelSpanType(alpha) -> int:
+    if alpha == 0:
+        return SPAN_SKIP
+    return SPAN_OPAQUE if alpha == ALPHA_LEVELS else SPAN_BLEND
+
+
+def encodeRow(pix, width, y):
+    """
+    encode a row of pixels as spans. returns (list of uint16 values, pixels per span type)
+    """
+    values = []
+    stats = [0, 0, 0]
+    row = [pix[x, y] for x in range(width)]
+    types = [pixelSpanType(pixelAlpha(p[3])) for p in row]
+
+    # trailing transparency is implied by the end of row
+    end = width
+    while end > 0 and types[end - 1] == SPAN_SKIP:
+        end -= 1
+
+    x = 0
+    while x < end:
+        spanType = types[x]
+        length = 1
+        while x + length < end and types[x + length] == spanType and length < SPAN_MAX_LENGTH:
+            length += 1
+
+        values.append(spanHeader(spanType, length))
+        for r, g, b, a in row[x:x + length]:
+            if spanType == SPAN_OPAQUE:
+                values.append(encodeBGR12(r, g, b))
+            elif spanType == SPAN_BLEND:
+                values.append(encodeBlend(r, g, b, ALPHA_LEVELS - pixelAlpha(a)))
+
+        stats[spanType] += length
+        x += length
+
+    values.append(spanHeader(SPAN_SKIP, 0))   # end of row
+    return values, stats
+
+
+def processImageFile(infile, srcOutput, hdrOutput, args, inRam) -> None:
+    """
+    process a single image and output it to the header and source files
+    """
+    varName = os.path.split(infile)[1]
+    varName = os.path.splitext(varName)[0]
+    varName = re.sub('[^0-9a-zA-Z]+', '', args['prefix'] + varName)
+
+    try:
+        src = Image.open(infile).convert("RGBA")
+        pix = src.load()
+
+        rowOffsets = []
+        spans = []
+        totals = [0, 0, 0]
+        for y in range(src.height):
+            rowOffsets.append(len(spans))
+            values, stats = encodeRow(pix, src.width, y)
+            spans.extend(values)
+            totals = [t + s for t, s in zip(totals, stats)]
+
+        comment = (f"\n\n/* source: {infile}\n"
+                   f" * size  : {src.width}px x {src.height}px\n"
+                   f" *       : {len(spans) * 2 + len(rowOffsets) * 4} bytes\n"
+                   f" * pixels: {totals[SPAN_OPAQUE]} opaque, {totals[SPAN_BLEND]} blended\n"
+                   f" */\n")
+
+        # ram arrays aren't const (or the compiler would place them in flash anyway)
+        storage = ("" if inRam else "const ") + "uint{0}_t __aligned(4) " + ("" if inRam else "__in_flash() ")
+
+        hdrOutput.write(comment)
+        hdrOutput.write(f"extern const VgaSprite {varName};\n")
+
+        srcOutput.write(comment)
+        srcOutput.write(f"static {storage.format(32)}{varName}_rows[] = {{")
+        srcOutput.write(", ".join(str(o) for o in rowOffsets) + "};\n")
+        srcOutput.write(f"static {storage.format(16)}{varName}_spans[] = {{")
+        for i in range(0, len(spans), 16):
+            srcOutput.write("\n  " + ", ".join("{0:#0{1}x}".format(v, 6) for v in spans[i:i + 16]) + ",")
+        srcOutput.write("};\n")
+        srcOutput.write(f"const VgaSprite {varName} = {{ {src.width}, {src.height}, {varName}_rows, {varName}_spans }};")
+
+        if args['verbose']:
+            print(f"{infile}: {len(spans) * 2} bytes of spans")
+
+        src.close()
+
+    except IOError:
+        print("cannot convert", infile)
+
+    return
+
+
+# program entry
+if __name__ == "__main__":
+    sys.exit(main())